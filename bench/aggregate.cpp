@@ -0,0 +1,115 @@
+#include <charconv>
+#include <cstdlib>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "bench.hpp"
+#include "csv/csv_parser.hpp"
+#include "csv/query.hpp"
+
+// Compares the query kernels with hand-written loops over a nested
+// vector-of-strings copy of the table, the layout csv_table used to have.
+// The loops use the same hash containers and number conversion as the
+// kernels, so that the difference is the layout and the kernels' blocking.
+
+namespace {
+
+using nested = std::vector<std::vector<std::string>>;
+
+nested to_nested(const csv::csv_table &table)
+{
+    nested rows;
+    for (csv::row_view row : table.rows())
+    {
+        rows.emplace_back(row.begin(), row.end());
+    }
+    return rows;
+}
+
+// Like the kernels, skips cells that are not numbers instead of throwing.
+std::optional<double> parse_number(const std::string &cell)
+{
+    double value = 0;
+    auto result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+    if (result.ec != std::errc() || result.ptr != cell.data() + cell.size())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+csv::query::aggregate naive_summarize(const nested &rows, std::size_t column)
+{
+    csv::query::aggregate result;
+    for (const auto &row : rows)
+    {
+        if (auto number = parse_number(row[column]))
+        {
+            result.add(*number);
+        }
+    }
+    return result;
+}
+
+std::size_t naive_count_distinct(const nested &rows, std::size_t column)
+{
+    std::unordered_set<std::string_view> seen;
+    for (const auto &row : rows)
+    {
+        seen.insert(row[column]);
+    }
+    return seen.size();
+}
+
+std::size_t naive_group_by(const nested &rows, std::size_t key, std::size_t value)
+{
+    std::unordered_map<std::string_view, csv::query::aggregate> groups;
+    for (const auto &row : rows)
+    {
+        csv::query::aggregate &group = groups[row[key]];
+        if (auto number = parse_number(row[value]))
+        {
+            group.add(*number);
+        }
+    }
+    return groups.size();
+}
+
+template<typename F>
+void run(const char *name, F &&f, std::size_t bytes)
+{
+    double result = 0;
+    double time = bench::measure([&] { result = static_cast<double>(f()); });
+    bench::report(name, time, bytes);
+    std::printf("%-32s %12.2f\n", "", result);
+}
+
+} // namespace
+
+int main(int argc, const char **argv)
+{
+    std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    auto path = bench::temp_path("aggregate.csv");
+    std::size_t bytes = bench::generate_csv(path, rows);
+    csv::dialect with_header = csv::dialects::standard;
+    with_header.header = true;
+    csv::csv_table table = csv::import_csv(path, with_header);
+    std::filesystem::remove(path);
+    nested copy = to_nested(table);
+
+    const std::size_t name = table.column("name");
+    const std::size_t amount = table.column("amount");
+
+    run("naive sum", [&] { return naive_summarize(copy, amount).sum; }, bytes);
+    run("kernel sum, 1 thread", [&] { return csv::query::sum(table, amount, 1); }, bytes);
+    run("kernel sum, all threads", [&] { return csv::query::sum(table, amount); }, bytes);
+    run("naive max", [&] { return naive_summarize(copy, amount).max; }, bytes);
+    run("kernel max, all threads", [&] { return csv::query::max(table, amount); }, bytes);
+    run("naive count distinct", [&] { return naive_count_distinct(copy, name); }, bytes);
+    run("kernel count distinct, 1 thread", [&] { return csv::query::count_distinct(table, name, 1); }, bytes);
+    run("kernel count distinct, all", [&] { return csv::query::count_distinct(table, name); }, bytes);
+    run("naive group by", [&] { return naive_group_by(copy, name, amount); }, bytes);
+    run("kernel group by, 1 thread", [&] { return csv::query::group_by(table, name, amount, 1).size(); }, bytes);
+    run("kernel group by, all threads", [&] { return csv::query::group_by(table, name, amount).size(); }, bytes);
+}
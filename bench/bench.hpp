@@ -0,0 +1,57 @@
+#ifndef BENCH_BENCH_HPP
+#define BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace bench {
+
+// Wall time of a single call in seconds.
+template<typename F>
+double measure(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+inline void report(const std::string &name, double seconds, std::size_t bytes)
+{
+    std::printf("%-32s %8.3f s %10.1f MB/s\n", name.c_str(), seconds,
+                static_cast<double>(bytes) / seconds / 1e6);
+}
+
+inline std::filesystem::path temp_path(const std::string &name)
+{
+    return std::filesystem::temp_directory_path() / ("parse-csv-bench-" + name);
+}
+
+// A table of `rows` rows mixing numbers, plain and quoted strings.
+inline std::string generate_csv(std::size_t rows)
+{
+    std::mt19937 random(42);
+    std::string out = "id,name,comment,amount\n";
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        out += std::to_string(i) + ",user " + std::to_string(random() % 1000) +
+               ",\"note, " + std::to_string(random() % 97) + "\"," +
+               std::to_string(random() % 100000) + '.' + std::to_string(random() % 100) + '\n';
+    }
+    return out;
+}
+
+inline std::size_t generate_csv(const std::filesystem::path &path, std::size_t rows)
+{
+    std::string content = generate_csv(rows);
+    std::ofstream(path, std::ios::binary) << content;
+    return content.size();
+}
+
+} // namespace bench
+
+#endif // BENCH_BENCH_HPP
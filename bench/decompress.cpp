@@ -0,0 +1,142 @@
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#ifdef PARSE_CSV_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PARSE_CSV_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "bench.hpp"
+#include "csv/csv_parser.hpp"
+
+// Compares importing a compressed file directly with the usual workaround of
+// decompressing it to a temporary file first, for every format compiled in.
+// Both imports must give the table of the plain file.
+
+using convert = std::function<void(const std::filesystem::path &, const std::filesystem::path &)>;
+
+#ifdef PARSE_CSV_WITH_ZLIB
+static void gzip_file(const std::filesystem::path &from, const std::filesystem::path &to)
+{
+    std::ifstream in(from, std::ios::binary);
+    gzFile out = gzopen(to.c_str(), "wb6");
+    std::vector<char> buffer(1 << 20);
+    while (in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || in.gcount())
+    {
+        gzwrite(out, buffer.data(), static_cast<unsigned>(in.gcount()));
+    }
+    gzclose(out);
+}
+
+static void gunzip_file(const std::filesystem::path &from, const std::filesystem::path &to)
+{
+    gzFile in = gzopen(from.c_str(), "rb");
+    std::ofstream out(to, std::ios::binary);
+    std::vector<char> buffer(1 << 20);
+    int got;
+    while ((got = gzread(in, buffer.data(), static_cast<unsigned>(buffer.size()))) > 0)
+    {
+        out.write(buffer.data(), got);
+    }
+    gzclose(in);
+}
+#endif
+
+#ifdef PARSE_CSV_WITH_ZSTD
+static void zstd_file(const std::filesystem::path &from, const std::filesystem::path &to)
+{
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary);
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, 3);
+    std::vector<char> buffer(1 << 20), packed(ZSTD_CStreamOutSize());
+    bool last = false;
+    while (!last)
+    {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        last = !in;
+        ZSTD_inBuffer input{buffer.data(), static_cast<std::size_t>(in.gcount()), 0};
+        std::size_t remaining;
+        do
+        {
+            ZSTD_outBuffer output{packed.data(), packed.size(), 0};
+            remaining = ZSTD_compressStream2(context, &output, &input, last ? ZSTD_e_end : ZSTD_e_continue);
+            out.write(packed.data(), static_cast<std::streamsize>(output.pos));
+        } while (last ? remaining != 0 : input.pos != input.size);
+    }
+    ZSTD_freeCCtx(context);
+}
+
+static void unzstd_file(const std::filesystem::path &from, const std::filesystem::path &to)
+{
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary);
+    ZSTD_DCtx *context = ZSTD_createDCtx();
+    std::vector<char> packed(ZSTD_DStreamInSize()), buffer(ZSTD_DStreamOutSize());
+    while (in.read(packed.data(), static_cast<std::streamsize>(packed.size())) || in.gcount())
+    {
+        ZSTD_inBuffer input{packed.data(), static_cast<std::size_t>(in.gcount()), 0};
+        while (input.pos != input.size)
+        {
+            ZSTD_outBuffer output{buffer.data(), buffer.size(), 0};
+            ZSTD_decompressStream(context, &output, &input);
+            out.write(buffer.data(), static_cast<std::streamsize>(output.pos));
+        }
+    }
+    ZSTD_freeDCtx(context);
+}
+#endif
+
+// Times one format and returns false if an import differs from the plain one.
+static bool run_format(const std::string &format, const convert &compress, const convert &decompress,
+                       const std::filesystem::path &plain, const csv::csv_table &expected, std::size_t bytes)
+{
+    auto packed = bench::temp_path("plain.csv." + format);
+    auto unpacked = bench::temp_path("unpacked.csv");
+    compress(plain, packed);
+
+    bool same = true;
+    double temp_time = bench::measure([&] {
+        decompress(packed, unpacked);
+        same = csv::import_csv(unpacked) == expected && same;
+    });
+    double stream_time = bench::measure([&] { same = csv::import_csv(packed) == expected && same; });
+
+    bench::report(format + " to temp file + parse", temp_time, bytes);
+    bench::report("streaming " + format + " + parse", stream_time, bytes);
+    if (!same)
+    {
+        std::printf("%s import differs from the plain file\n", format.c_str());
+    }
+
+    std::filesystem::remove(packed);
+    std::filesystem::remove(unpacked);
+    return same;
+}
+
+int main(int argc, const char **argv)
+{
+    std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    auto plain = bench::temp_path("plain.csv");
+    std::size_t bytes = bench::generate_csv(plain, rows);
+
+    csv::csv_table expected;
+    double plain_time = bench::measure([&] { expected = csv::import_csv(plain); });
+    std::printf("%zu rows, %zu bytes uncompressed\n", expected.height(), bytes);
+    bench::report("plain file", plain_time, bytes);
+
+    bool same = true;
+#ifdef PARSE_CSV_WITH_ZLIB
+    same = run_format("gz", gzip_file, gunzip_file, plain, expected, bytes) && same;
+#endif
+#ifdef PARSE_CSV_WITH_ZSTD
+    same = run_format("zst", zstd_file, unzstd_file, plain, expected, bytes) && same;
+#endif
+
+    std::filesystem::remove(plain);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <cstdlib>
+#include <fstream>
+
+#include <sys/resource.h>
+
+#include "bench.hpp"
+#include "csv/export.hpp"
+
+// End-to-end conversion of a file to JSON Lines and to the columnar format,
+// streaming rows from the parser versus importing a csv_table first. The
+// streaming runs go first, since the peak resident size only grows.
+
+namespace {
+
+double peak_rss_mb()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024;
+}
+
+template<typename F>
+void run(const char *name, F &&f, std::size_t bytes)
+{
+    double time = bench::measure(f);
+    bench::report(name, time, bytes);
+    std::printf("%-32s %10.1f MB peak RSS\n", "", peak_rss_mb());
+}
+
+template<typename Writer>
+void convert_table(const std::string &path, const csv::dialect &d, const std::string &output)
+{
+    csv::csv_table table = csv::import_csv(path, d);
+    std::ofstream out(output, std::ios::binary);
+    Writer writer(out);
+    if (table.has_header())
+    {
+        writer.header(table.header());
+    }
+    for (csv::row_view row : table.rows())
+    {
+        writer.row(row);
+    }
+    writer.finish();
+}
+
+} // namespace
+
+int main(int argc, const char **argv)
+{
+    std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    auto input = bench::temp_path("export.csv");
+    auto output = bench::temp_path("export.out");
+    std::size_t bytes = bench::generate_csv(input, rows);
+    csv::dialect d = csv::dialects::standard;
+    d.header = true;
+
+    std::printf("%zu rows, %zu bytes, %.1f MB peak RSS before\n", rows, bytes, peak_rss_mb());
+    run("streaming to JSON Lines", [&] {
+        std::ofstream out(output, std::ios::binary);
+        csv::export_jsonl(input, d, out);
+    }, bytes);
+    run("streaming to columnar", [&] {
+        std::ofstream out(output, std::ios::binary);
+        csv::export_columnar(input, d, out);
+    }, bytes);
+    run("table, then JSON Lines", [&] { convert_table<csv::jsonl_writer>(input, d, output); }, bytes);
+    run("table, then columnar", [&] { convert_table<csv::columnar_writer>(input, d, output); }, bytes);
+
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+}
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "bench.hpp"
+#include "csv/csv_parser.hpp"
+
+// Counts heap allocations per row for the ways of filling a csv_table:
+// the grammar with its tree, a vector of strings per row copied into the
+// table, and the row builder the import path uses.
+
+static std::atomic<std::size_t> allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using standard = csv::fixed_dialect<csv::dialects::standard>;
+
+parser::scope memory_scope(const std::string &input)
+{
+    return parser::scope(std::make_shared<parser::string_reader>(input), parser::position());
+}
+
+csv::csv_table via_grammar(const std::string &input)
+{
+    auto sc = memory_scope(input);
+    return csv::csv_table(parser::get_ast(csv::csv_parser()->parse(sc)));
+}
+
+csv::csv_table via_row_vectors(const std::string &input)
+{
+    auto sc = memory_scope(input);
+    csv::row_scanner<standard> scanner;
+    csv::csv_table table;
+    std::vector<std::string> cells;
+    while (sc.has_next())
+    {
+        scanner.scan(sc, cells);
+        table.add_row(std::vector<std::string>(cells));
+    }
+    return table;
+}
+
+csv::csv_table via_row_builder(const std::string &input)
+{
+    auto sc = memory_scope(input);
+    return csv::detail::import_rows(sc, csv::row_scanner<standard>(), false, nullptr);
+}
+
+void run(const char *name, csv::csv_table (*ingest)(const std::string &), const std::string &input)
+{
+    std::size_t before = allocations.load();
+    std::size_t height = 0;
+    double time = bench::measure([&] { height = ingest(input).height(); });
+    std::size_t count = allocations.load() - before;
+    bench::report(name, time, input.size());
+    std::printf("%-32s %10.2f allocations per row\n", "", static_cast<double>(count) / height);
+}
+
+} // namespace
+
+int main(int argc, const char **argv)
+{
+    std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::string input = bench::generate_csv(rows);
+    std::string small = bench::generate_csv(std::min<std::size_t>(rows, 20000));
+
+    run("grammar + tree", via_grammar, small);
+    run("row vectors + add_row", via_row_vectors, input);
+    run("row builder", via_row_builder, input);
+}
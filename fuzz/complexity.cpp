@@ -0,0 +1,205 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "csv/csv_parser.hpp"
+#include "csv/stream.hpp"
+#include "csv/validate.hpp"
+
+// Flags inputs whose parse time grows faster than their size. Every pattern
+// is generated at a small and a large size and timed with each engine:
+// strict, lenient and streaming imports, validation and the grammar; the
+// growth exponent log(t) / log(n) of a linear engine stays close to 1.
+// Files given as arguments are used as extra patterns by repeating them.
+
+namespace {
+
+constexpr double superlinear_exponent = 1.4;
+
+struct pattern
+{
+    std::string name;
+    std::function<std::string(std::size_t)> make;
+};
+
+std::string repeat(const std::string &unit, std::size_t size)
+{
+    std::string result;
+    while (result.size() < size)
+    {
+        result += unit;
+    }
+    return result;
+}
+
+std::vector<pattern> builtin_patterns()
+{
+    return {
+            {"many rows", [](std::size_t n) { return repeat("abc,def,\"g,h\"\n", n); }},
+            {"wide row", [](std::size_t n) { return repeat("a,", n) + "a\n"; }},
+            {"long quoted cell", [](std::size_t n) { return "\"" + std::string(n, 'a') + "\"\n"; }},
+            {"unterminated quote", [](std::size_t n) { return "a,\"" + std::string(n, 'a'); }},
+            {"doubled quotes", [](std::size_t n) { return "\"" + repeat("\"\"", n) + "\"\n"; }},
+            {"stray quotes", [](std::size_t n) { return repeat("a\"", n) + "\n"; }},
+            {"empty lines", [](std::size_t n) { return std::string(n, '\n'); }},
+            {"quoted newlines", [](std::size_t n) { return "\"" + repeat("a\n", n) + "\",b\n"; }},
+            {"malformed rows", [](std::size_t n) { return repeat("a,\"b\"c,d\n", n); }},
+            {"stray quote per row", [](std::size_t n) { return repeat("a,b\"c\n", n); }},
+            {"unclosed quote per row", [](std::size_t n) { return repeat("a,\"b\\\n", n); }},
+            {"unclosed quote, bad rows", [](std::size_t n) { return "\"a\n" + repeat("b,c\"d\n", n); }},
+            {"open quote, escaped quotes", [](std::size_t n) { return "\"a\n" + repeat("b\\\"c\n", n); }},
+            {"escaped quotes", [](std::size_t n) { return repeat("\"a\\\"\n", n) + "\"\n"; }},
+            {"blanks before quotes", [](std::size_t n) { return repeat(" \"a\n,b\" ,c\n", n); }},
+    };
+}
+
+double best_time(const std::function<void()> &f)
+{
+    double best = 1e9;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void parse_with_grammar(const std::string &input)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    auto result = csv::csv_parser()->parse(sc);
+    if (parser::no_error(result))
+    {
+        try { csv::csv_table table(parser::get_ast(result)); } catch (const std::logic_error &) {}
+    }
+}
+
+// Dialect run through the generic scanner, with the escape and trimming
+// paths that none of the specialised ones take.
+const csv::dialect generic_dialect{.escape = '\\', .trim = true};
+
+void parse_with_scanner(const std::string &input)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    try
+    {
+        csv::detail::import_rows(sc, csv::row_scanner(csv::fixed_dialect<csv::dialects::standard>{}), false, nullptr);
+    } catch (const std::exception &) {}
+}
+
+void parse_with_generic(const std::string &input)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    try
+    {
+        csv::detail::import_rows(sc, csv::row_scanner(csv::runtime_dialect{generic_dialect}), false, nullptr);
+    } catch (const std::exception &) {}
+}
+
+// Skips malformed rows instead of stopping at the first one, which is where
+// resyncing after an unclosed quote can rescan the input.
+void parse_lenient(const std::string &input)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    csv::error_log errors;
+    csv::detail::import_rows(sc, csv::row_scanner(csv::fixed_dialect<csv::dialects::standard>{}), false, &errors);
+}
+
+struct null_handler
+{
+    void header(csv::row_view) {}
+
+    void row(csv::row_view) {}
+};
+
+void stream_lenient(const std::string &input)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    csv::error_log errors;
+    null_handler handler;
+    csv::detail::stream_rows(sc, csv::row_scanner(csv::runtime_dialect{generic_dialect}), false, &errors, handler);
+}
+
+void validate(const std::string &input)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    csv::detail::validate_rows(sc, csv::row_scanner(csv::fixed_dialect<csv::dialects::standard>{}), false);
+}
+
+struct engine
+{
+    const char *name;
+    std::function<void(const std::string &)> run;
+    std::size_t from, to;
+};
+
+// The grammar builds a tree per character and is timed on smaller inputs.
+const engine engines[] = {
+        {"grammar", parse_with_grammar, 1 << 12, 1 << 16},
+        {"scanner", parse_with_scanner, 1 << 14, 1 << 20},
+        {"generic", parse_with_generic, 1 << 14, 1 << 20},
+        {"lenient", parse_lenient, 1 << 14, 1 << 20},
+        {"stream", stream_lenient, 1 << 14, 1 << 20},
+        {"validate", validate, 1 << 14, 1 << 20},
+};
+
+// Average growth exponent over the doublings from `from` to `to`, which
+// is less sensitive to timer noise than any single doubling.
+double growth(const pattern &p, const std::function<void(const std::string &)> &engine,
+              std::size_t from, std::size_t to)
+{
+    std::string small = p.make(from), large = p.make(to);
+    double small_time = best_time([&] { engine(small); });
+    double large_time = best_time([&] { engine(large); });
+    double doublings = std::log2(static_cast<double>(large.size()) / static_cast<double>(small.size()));
+    if (small_time < 1e-6 || doublings <= 0)
+    {
+        return 0;
+    }
+    return std::log2(large_time / small_time) / doublings;
+}
+
+} // namespace
+
+int main(int argc, const char **argv)
+{
+    std::vector<pattern> patterns = builtin_patterns();
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream in(argv[i], std::ios::binary);
+        std::string seed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (!seed.empty())
+        {
+            patterns.push_back({argv[i], [seed](std::size_t n) { return repeat(seed, n); }});
+        }
+    }
+
+    bool flagged = false;
+    std::printf("%-32s", "pattern");
+    for (const engine &e : engines)
+    {
+        std::printf(" %9s", e.name);
+    }
+    std::printf("\n");
+    for (const auto &p : patterns)
+    {
+        bool superlinear = false;
+        std::printf("%-32s", p.name.c_str());
+        for (const engine &e : engines)
+        {
+            double exponent = growth(p, e.run, e.from, e.to);
+            superlinear = superlinear || exponent > superlinear_exponent;
+            std::printf(" %9.2f", exponent);
+        }
+        flagged = flagged || superlinear;
+        std::printf("%s\n", superlinear ? "  SUPERLINEAR" : "");
+    }
+    return flagged ? 1 : 0;
+}
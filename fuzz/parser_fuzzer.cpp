@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+
+#include <unistd.h>
+
+#ifdef PARSE_CSV_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PARSE_CSV_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "csv/csv_parser.hpp"
+#include "csv/index.hpp"
+#include "csv/stream.hpp"
+#include "csv/validate.hpp"
+
+// Differential fuzz target: every engine must accept the same inputs, build
+// equal tables and report errors at the same positions. The first byte of
+// the input picks the dialect and the block size of the pipelined reader.
+
+namespace {
+
+const csv::dialect fuzzed_dialects[] = {
+        csv::dialects::standard,
+        csv::dialects::rfc4180,
+        csv::dialects::semicolon,
+        csv::dialects::tsv,
+        {.trim = true},
+        {.escape = '\\'},
+        {.terminator = csv::line_terminator::lf},
+        {.delimiter = '|', .quote = '\'', .escape = '\0', .trim = true},
+};
+
+struct outcome
+{
+    std::optional<csv::csv_table> table;
+    std::string error;
+
+    bool operator==(const outcome &) const = default;
+};
+
+// Hands out the input a few bytes at a time to exercise block filling.
+class string_source : public parser::block_source
+{
+  public:
+    explicit string_source(std::string content)
+            : content_(std::move(content)) {}
+
+    std::size_t read(char *dst, std::size_t size) override
+    {
+        std::size_t got = std::min({size, content_.size() - offset_, std::size_t{3}});
+        std::memcpy(dst, content_.data() + offset_, got);
+        offset_ += got;
+        return got;
+    }
+
+  private:
+    std::string content_;
+    std::size_t offset_ = 0;
+};
+
+// Compressed copies of the input, read back through the decompressing
+// sources to check that they hand out the same bytes.
+std::vector<std::pair<const char *, std::unique_ptr<parser::block_source>>> compressed_sources(const std::string &input)
+{
+    std::vector<std::pair<const char *, std::unique_ptr<parser::block_source>>> sources;
+#ifdef PARSE_CSV_WITH_ZLIB
+    std::string gzipped(compressBound(static_cast<uLong>(input.size())), '\0');
+    uLongf gzipped_size = gzipped.size();
+    compress2(reinterpret_cast<Bytef *>(gzipped.data()), &gzipped_size,
+              reinterpret_cast<const Bytef *>(input.data()), static_cast<uLong>(input.size()), 6);
+    gzipped.resize(gzipped_size);
+    sources.emplace_back("in-memory and gzip input", std::make_unique<parser::gzip_source>(
+            std::make_unique<string_source>(std::move(gzipped)), "fuzz input"));
+#endif
+#ifdef PARSE_CSV_WITH_ZSTD
+    std::string packed(ZSTD_compressBound(input.size()), '\0');
+    packed.resize(ZSTD_compress(packed.data(), packed.size(), input.data(), input.size(), 1));
+    sources.emplace_back("in-memory and zstd input", std::make_unique<parser::zstd_source>(
+            std::make_unique<string_source>(std::move(packed)), "fuzz input"));
+#endif
+    return sources;
+}
+
+void check(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "Engines disagree: %s\n", what);
+        std::abort();
+    }
+}
+
+outcome run_grammar(const std::string &input, const csv::dialect &d)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    auto result = csv::csv_parser(d)->parse(sc);
+    if (!parser::no_error(result))
+    {
+        return {std::nullopt, parser::get_error(result).what()};
+    }
+    try
+    {
+        return {csv::csv_table(parser::get_ast(result)), ""};
+    } catch (const std::logic_error &e)
+    {
+        return {std::nullopt, e.what()};
+    }
+}
+
+bool grammar_accepts(const std::string &input, const csv::dialect &d, bool build_ast)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    sc.build_ast = build_ast;
+    return parser::no_error(csv::csv_parser(d)->parse(sc));
+}
+
+// Validates with the grammar alone: no tree is built and the cells of each
+// row are counted with m_count(), as validate_rows() counts them with the
+// scanner.
+csv::validation_result validate_with_grammar(const std::string &input, const csv::dialect &d)
+{
+    auto cells = std::make_shared<parser::counter>();
+    parser::parser_ptr row = csv::csv_row_parser(d, cells);
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    sc.build_ast = false;
+    csv::validation_result result;
+    while (sc.has_next())
+    {
+        parser::position start = sc.pos;
+        cells->reset();
+        if (!parser::no_error(row->parse(sc)))
+        {
+            result.error = csv::row_error{start, "malformed row"};
+            break;
+        }
+        if (result.columns != 0 && cells->count() != result.columns)
+        {
+            result.error = csv::row_error{start, csv::detail::width_mismatch};
+            break;
+        }
+        result.columns = cells->count();
+        ++result.rows;
+    }
+    return result;
+}
+
+template<typename DialectT>
+outcome run_scanner(std::shared_ptr<parser::input_reader> reader, DialectT dialect, csv::error_log *errors)
+{
+    parser::scope sc(std::move(reader), parser::position());
+    try
+    {
+        return {csv::detail::import_rows(sc, csv::row_scanner(dialect), false, errors), ""};
+    } catch (const std::exception &e)
+    {
+        return {std::nullopt, e.what()};
+    }
+}
+
+// Rebuilds the table from streamed rows.
+struct table_handler
+{
+    csv::csv_table table;
+
+    void header(csv::row_view) {}
+
+    void row(csv::row_view cells) { table.emplace_row(cells); }
+};
+
+template<typename DialectT>
+outcome run_stream(const std::string &input, DialectT dialect, csv::error_log &errors)
+{
+    parser::scope sc(std::make_shared<parser::string_reader>(input), parser::position());
+    table_handler handler;
+    try
+    {
+        csv::detail::stream_rows(sc, csv::row_scanner(dialect), false, &errors, handler);
+        return {std::move(handler.table), ""};
+    } catch (const std::exception &e)
+    {
+        return {std::nullopt, e.what()};
+    }
+}
+
+// Input file of the index check, named after the process since parallel
+// fuzzing jobs share the temp directory, and removed with its index on exit.
+struct temp_input
+{
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("parse-csv-fuzz-" + std::to_string(getpid()) + ".csv")).string();
+
+    ~temp_input()
+    {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        std::filesystem::remove(csv::index_path(path), ignored);
+    }
+};
+
+// Reads every row of the input through a sparse index with a small stride,
+// so that most rows are reached by scanning past others.
+std::vector<std::vector<std::string>> indexed_rows(const std::string &input, const csv::dialect &d)
+{
+    static const temp_input file;
+    const std::string &path = file.path;
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << input;
+    std::filesystem::remove(csv::index_path(path));
+    std::vector<std::vector<std::string>> rows;
+    csv::indexed_csv indexed = csv::open_indexed(path, d, 3);
+    for (std::size_t i = 0; i < indexed.size(); ++i)
+    {
+        rows.push_back(indexed.row(i));
+    }
+    return rows;
+}
+
+std::vector<std::vector<std::string>> table_rows(const csv::csv_table &table)
+{
+    std::vector<std::vector<std::string>> rows;
+    for (csv::row_view row : table.rows())
+    {
+        rows.emplace_back(row.begin(), row.end());
+    }
+    return rows;
+}
+
+std::vector<std::size_t> error_offsets(const csv::error_log &errors)
+{
+    std::vector<std::size_t> offsets;
+    for (const auto &e : errors.errors())
+    {
+        offsets.push_back(e.pos.get_abs_pos());
+    }
+    return offsets;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+    const std::size_t variants = std::size(fuzzed_dialects);
+    const csv::dialect &d = fuzzed_dialects[data[0] % variants];
+    const std::size_t block_size = data[0] / variants % 8 + 1;
+    const std::string input(reinterpret_cast<const char *>(data) + 1, size - 1);
+    auto memory = [&] { return std::make_shared<parser::string_reader>(input); };
+
+    outcome grammar = run_grammar(input, d);
+    outcome fixed = csv::visit_dialect(d, [&](auto dialect) { return run_scanner(memory(), dialect, nullptr); });
+    outcome runtime = run_scanner(memory(), csv::runtime_dialect{d}, nullptr);
+    outcome pipelined = run_scanner(
+            std::make_shared<parser::pipelined_reader>(std::make_unique<string_source>(input), block_size, 1),
+            csv::runtime_dialect{d}, nullptr);
+    check(grammar == fixed, "grammar and specialised scanner");
+    check(grammar_accepts(input, d, false) == grammar_accepts(input, d, true), "grammar with and without tree");
+    check(fixed == runtime, "specialised and runtime scanner");
+    check(runtime == pipelined, "in-memory and pipelined reader");
+    for (auto &[what, source] : compressed_sources(input))
+    {
+        outcome decompressed = run_scanner(
+                std::make_shared<parser::pipelined_reader>(std::move(source), block_size, 1),
+                csv::runtime_dialect{d}, nullptr);
+        check(runtime == decompressed, what);
+    }
+
+    csv::error_log fixed_errors, runtime_errors;
+    outcome fixed_lenient = csv::visit_dialect(d, [&](auto dialect) {
+        return run_scanner(memory(), dialect, &fixed_errors);
+    });
+    outcome runtime_lenient = run_scanner(memory(), csv::runtime_dialect{d}, &runtime_errors);
+    check(fixed_lenient == runtime_lenient, "lenient specialised and runtime scanner");
+    check(error_offsets(fixed_errors) == error_offsets(runtime_errors), "lenient error positions");
+    check(!fixed_errors.empty() || fixed_lenient == fixed, "lenient and strict import of valid input");
+
+    csv::error_log stream_errors;
+    outcome streamed = run_stream(input, csv::runtime_dialect{d}, stream_errors);
+    check(streamed == runtime_lenient, "lenient streaming and import");
+    check(error_offsets(stream_errors) == error_offsets(runtime_errors), "lenient streaming error positions");
+
+    parser::scope validate_scope(memory(), parser::position());
+    csv::validation_result validation = csv::detail::validate_rows(
+            validate_scope, csv::row_scanner(csv::runtime_dialect{d}), false);
+    check(validation.ok() == fixed_errors.empty(), "validation and lenient import");
+    check(validation.ok() || validation.error->pos.get_abs_pos() == error_offsets(fixed_errors).front(),
+          "validation error position");
+    check(!validation.ok() || (validation.rows == fixed.table->height() && validation.columns == fixed.table->width()),
+          "validation counts");
+    csv::validation_result counted = validate_with_grammar(input, d);
+    check(counted.ok() == validation.ok() && counted.rows == validation.rows && counted.columns == validation.columns,
+          "cells counted by the grammar and the scanner");
+    check(counted.ok() || counted.error->pos.get_abs_pos() == validation.error->pos.get_abs_pos(),
+          "grammar and scanner validation error position");
+
+    if (fixed.table)
+    {
+        check(indexed_rows(input, d) == table_rows(*fixed.table), "indexed rows and import");
+    }
+
+    // A bad leading cell makes the first row malformed without changing how
+    // the rest of it is quoted. The lenient import must skip that row whole
+    // and keep exactly the other rows of the strict import, never a line
+    // from inside one of its quoted cells.
+    if (fixed.table && fixed.table->height() != 0 && d.quote != '\0')
+    {
+        const std::string bad_cell{d.quote, 'X', d.quote, 'Y', d.delimiter};
+        csv::error_log broken_errors;
+        outcome broken = run_scanner(std::make_shared<parser::string_reader>(bad_cell + input),
+                                     csv::runtime_dialect{d}, &broken_errors);
+        auto strict_rows = table_rows(*fixed.table);
+        strict_rows.erase(strict_rows.begin());
+        check(broken.table && table_rows(*broken.table) == strict_rows && broken_errors.errors().size() == 1,
+              "lenient rows are rows of the strict import");
+    }
+
+    if (fixed.table)
+    {
+        csv::detail::stat_counter counter(d);
+        counter.feed(input.data(), input.size());
+        check(counter.rows() == fixed.table->height(), "pre-scan row count");
+        check(fixed.table->height() == 0 || counter.columns() == fixed.table->width(), "pre-scan column count");
+    }
+    return 0;
+}
+
+#ifdef PARSE_CSV_STANDALONE_FUZZER
+// Without libFuzzer the target replays the files given as arguments.
+int main(int argc, const char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream in(argv[i], std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t *>(content.data()), content.size());
+    }
+    return 0;
+}
+#endif
@@ -44,14 +44,14 @@ class node
     bool disabled = false;
 };
 
-[[nodiscard]] std::vector<std::shared_ptr<node>> nodes(const std::shared_ptr<node> &v)
+[[nodiscard]] inline std::vector<std::shared_ptr<node>> nodes(const std::shared_ptr<node> &v)
 {
     return v == nullptr ? std::vector<std::shared_ptr<node>>{} : v->nodes();
 }
 
 using node_ptr = std::shared_ptr<node>;
 
-node_ptr make_node(const std::string &name)
+inline node_ptr make_node(const std::string &name)
 {
     return std::make_shared<node>(name);
 }
@@ -63,7 +63,7 @@ struct node_printer
 };
 
 namespace detail {
-void print_n(std::ostream &os, std::size_t n, const std::string &s)
+inline void print_n(std::ostream &os, std::size_t n, const std::string &s)
 {
     for (std::size_t i = 0; i < n; ++i)
     {
@@ -72,7 +72,7 @@ void print_n(std::ostream &os, std::size_t n, const std::string &s)
 }
 } // namespace detail
 
-std::ostream &operator<<(std::ostream &os, const node_printer &printer)
+inline std::ostream &operator<<(std::ostream &os, const node_printer &printer)
 {
     detail::print_n(os, printer.align, "\t");
     os << printer.v->get_name() << std::endl;
@@ -87,7 +87,7 @@ std::ostream &operator<<(std::ostream &os, const node_printer &printer)
     return os;
 }
 
-std::ostream &operator<<(std::ostream &os, const node_ptr &node)
+inline std::ostream &operator<<(std::ostream &os, const node_ptr &node)
 {
     os << node_printer{node, 0};
     return os;
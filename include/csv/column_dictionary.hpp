@@ -0,0 +1,156 @@
+#ifndef CSV_COLUMN_DICTIONARY_HPP
+#define CSV_COLUMN_DICTIONARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace csv {
+
+// Column names of a table interned into one buffer, with an open-addressing
+// hash table of column indices for constant-time name lookups. When a name
+// repeats, lookups return its first column.
+class column_dictionary
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::string_view;
+        using reference = std::string_view;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const column_dictionary *dictionary, std::size_t column)
+                : dictionary_(dictionary), column_(column) {}
+
+        std::string_view operator*() const { return dictionary_->name(column_); }
+
+        iterator &operator++() noexcept
+        {
+            ++column_;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator old = *this;
+            ++column_;
+            return old;
+        }
+
+        bool operator==(const iterator &) const = default;
+
+      private:
+        const column_dictionary *dictionary_ = nullptr;
+        std::size_t column_ = 0;
+    };
+
+    column_dictionary() = default;
+
+    template<typename Names>
+    explicit column_dictionary(const Names &names)
+    {
+        for (std::string_view name : names)
+        {
+            names_.append(name);
+            ends_.push_back(static_cast<std::uint32_t>(names_.size()));
+        }
+        slots_.assign(capacity_for(size()), empty_slot);
+        for (std::size_t column = 0; column < size(); ++column)
+        {
+            std::size_t slot = probe(name(column));
+            if (slots_[slot] == empty_slot)
+            {
+                slots_[slot] = static_cast<std::uint32_t>(column);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return ends_.size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return ends_.empty(); }
+
+    [[nodiscard]] std::string_view name(std::size_t column) const
+    {
+        std::size_t begin = column == 0 ? 0 : ends_[column - 1];
+        return std::string_view(names_).substr(begin, ends_[column] - begin);
+    }
+
+    std::string_view operator[](std::size_t column) const { return name(column); }
+
+    [[nodiscard]] std::optional<std::size_t> find(std::string_view name) const
+    {
+        if (slots_.empty())
+        {
+            return std::nullopt;
+        }
+        std::uint32_t column = slots_[probe(name)];
+        if (column == empty_slot)
+        {
+            return std::nullopt;
+        }
+        return column;
+    }
+
+    [[nodiscard]] std::size_t index(std::string_view name) const
+    {
+        if (auto column = find(name))
+        {
+            return *column;
+        }
+        throw std::out_of_range("No column named '" + std::string(name) + "'");
+    }
+
+    [[nodiscard]] iterator begin() const noexcept { return {this, 0}; }
+
+    [[nodiscard]] iterator end() const noexcept { return {this, size()}; }
+
+    bool operator==(const column_dictionary &other) const
+    {
+        return names_ == other.names_ && ends_ == other.ends_;
+    }
+
+  private:
+    static constexpr std::uint32_t empty_slot = UINT32_MAX;
+
+    // Power of two at least twice the number of names.
+    static std::size_t capacity_for(std::size_t names)
+    {
+        std::size_t capacity = 1;
+        while (capacity < names * 2)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // Slot holding `name`, or the empty slot where it would be inserted.
+    [[nodiscard]] std::size_t probe(std::string_view name) const
+    {
+        std::size_t mask = slots_.size() - 1;
+        std::size_t slot = std::hash<std::string_view>{}(name) & mask;
+        while (slots_[slot] != empty_slot && this->name(slots_[slot]) != name)
+        {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    std::string names_{};
+    std::vector<std::uint32_t> ends_{};
+    std::vector<std::uint32_t> slots_{};
+};
+
+} // namespace csv
+
+#endif //CSV_COLUMN_DICTIONARY_HPP
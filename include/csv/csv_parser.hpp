@@ -5,47 +5,218 @@
 #ifndef CSV_CSV_PARSER_HPP
 #define CSV_CSV_PARSER_HPP
 
+#include <optional>
+#include <stdexcept>
+
 #include "parser/combinators.hpp"
+#include "parser/decompress.hpp"
+#include "parser/pipelined_reader.hpp"
 #include "csv/csv_table.hpp"
+#include "csv/dialect.hpp"
+#include "csv/error_log.hpp"
+#include "csv/row_scanner.hpp"
+#include "csv/stat.hpp"
 #include "ast/ast.hpp"
 
 namespace csv {
 
-parser::parser_ptr csv_parser()
+// Grammar of one row. If `cells` is given, every cell of a parsed row is
+// added to it, which is how the width is checked without building a tree.
+inline parser::parser_ptr csv_row_parser(const dialect &d = dialects::standard,
+                                         const std::shared_ptr<parser::counter> &cells = nullptr)
 {
     using namespace parser;
     using namespace aliases;
 
-    parser_ptr comma = m_ignore(m_char(','));
-    parser_ptr quote = m_ignore(m_char('"'));
+    parser_ptr delimiter = m_ignore(m_char(d.delimiter));
+
+    std::unordered_set<char> special{d.delimiter, '\n'};
+    if (d.quote != '\0')
+        special.insert(d.quote);
+    if (d.terminator != line_terminator::lf)
+        special.insert('\r');
+    std::unordered_set<char> blanks{' ', '\t'};
+    blanks.erase(d.delimiter);
+
+    parser_ptr non_string_literal = m_concat(m_any(m_not_charset(special)));
+    if (d.trim)
+        non_string_literal = m_trim(non_string_literal, blanks);
+    parser_ptr cell = non_string_literal;
+
+    if (d.quote != '\0')
+    {
+        parser_ptr quote = m_ignore(m_char(d.quote));
+        parser_ptr literal_char = m_not_char(d.quote);
+        if (d.escape == d.quote)
+            literal_char = m_alt(literal_char, m_concat(m_seq(quote, m_char(d.quote))));
+        else if (d.escape != '\0')
+            literal_char = m_alt(m_not_charset(d.quote, d.escape),
+                                 m_concat(m_seq(m_ignore(m_char(d.escape)), m_any_char())));
+
+        parser_ptr string_literal = m_erase(m_concat(m_seq(quote,
+                                                           m_concat(m_any(literal_char)),
+                                                           quote)));
+        if (d.trim)
+        {
+            parser_ptr skip_blanks = m_ignore(m_any(m_charset(blanks)));
+            string_literal = m_concat(m_seq(skip_blanks, string_literal, skip_blanks));
+        }
+        cell = m_alt(string_literal, non_string_literal);
+    }
+
+    parser_ptr terminator;
+    switch (d.terminator)
+    {
+        case line_terminator::lf:
+            terminator = m_char('\n');
+            break;
+        case line_terminator::crlf:
+            terminator = m_seq(m_char('\r'), m_char('\n'));
+            break;
+        case line_terminator::any:
+            terminator = m_alt(m_char('\n'), m_seq(m_char('\r'), m_char('\n')));
+            break;
+    }
+
+    if (cells)
+        cell = m_count(cell, cells);
 
-    parser_ptr string_literal = m_erase(m_concat(m_seq(quote,
-                                                       m_concat(m_any(m_not_char('"'))),
-                                                       quote)));
-    parser_ptr non_string_literal = m_concat(m_any(m_not_charset(',', '"', '\n')));
-    parser_ptr cell = m_alt(string_literal, non_string_literal);
-    parser_ptr row = m_line(m_separator(cell, comma));
-    parser_ptr rows = m_erase(m_any(row));
+    return m_line(m_separator(cell, delimiter), terminator);
+}
+
+inline parser::parser_ptr csv_parser(const dialect &d = dialects::standard)
+{
+    using namespace parser;
+    using namespace aliases;
+
+    parser_ptr rows = m_erase(m_any(csv_row_parser(d)));
     parser_ptr csv = m_erase(m_eof(rows));
 
     return csv;
 }
 
-csv_table import_csv(const std::string &filename)
+namespace detail {
+// Lenient recovery from a row the scanner rejected, with the scope where
+// scanning stopped. Once a quote was found open up to the end of skip()'s
+// lookahead, `quotes` is cleared and later rows resync at their first line
+// end, so that each malformed row does not scan the rest of the input again.
+template<typename DialectT>
+void skip_malformed(parser::scope &sc, const row_scanner<DialectT> &scanner, const parser::position &start,
+                    const parser::exception::positional_error &error, error_log &errors, bool &quotes)
 {
-    using namespace parser;
+    bool quote_ran_to_end = !sc.has_next();
+    sc.pos = start;
+    if (scanner.skip(sc, quotes))
+    {
+        errors.record(start, error.get_reason(), error.get_position());
+        return;
+    }
+    quotes = false;
+    if (quote_ran_to_end)
+        errors.record(start, unclosed_quote);
+    else
+        errors.record(start, error.get_reason(), error.get_position());
+}
 
-    std::shared_ptr<input_reader> reader = std::make_shared<full_file_reader>(filename);
-    scope s(reader, position());
+// Reads rows with the scanner specialised for the dialect. Without an error
+// log the first malformed row aborts the import, reported the same way as
+// csv_parser() does; width mismatches are only reported if the rest of the
+// input is well-formed.
+template<typename DialectT>
+csv_table import_rows(parser::scope &sc, const row_scanner<DialectT> &scanner,
+                      bool header, error_log *errors, csv_table table = csv_table())
+{
+    bool width_error = false;
+    bool header_pending = header;
+    bool quotes = true;
+    std::vector<std::string> header_cells;
+    while (sc.has_next())
+    {
+        parser::position start = sc.pos;
+        sc.reader->discard_before(start);
+        csv_table::row_builder row(table);
+        auto error = header_pending ? scanner.scan(sc, header_cells) : scanner.scan(sc, row);
+        if (error)
+        {
+            if (!errors)
+            {
+                throw parser::exception::positional_error(start, "'EOF' is expected here");
+            }
+            skip_malformed(sc, scanner, start, *error, *errors, quotes);
+            continue;
+        }
+        if (header_pending)
+        {
+            header_pending = false;
+            table.set_header(header_cells);
+            continue;
+        }
+        if (width_error || !row.commit())
+        {
+            if (errors)
+                errors->record(start, width_mismatch);
+            else
+                width_error = true;
+        }
+    }
+    if (width_error)
+    {
+        throw std::logic_error(width_mismatch);
+    }
+    return table;
+}
 
-    auto result = csv_parser()->parse(s);
+inline std::shared_ptr<parser::input_reader> open_input(const std::string &filename)
+{
+    return std::make_shared<parser::pipelined_reader>(parser::open_source(filename));
+}
+
+inline std::shared_ptr<parser::input_reader> open_input(const std::string &filename, parser::compression kind)
+{
+    return std::make_shared<parser::pipelined_reader>(parser::open_source(filename, kind));
+}
+
+// The table is sized from the first block of the file only: an exact count
+// would read the whole file before parsing could start. Cell offsets are
+// reserved only when that block is the whole file, since a row count scaled
+// from short leading rows can ask for many times the memory the table needs.
+// The scaled cell bytes are bounded by the file size and always reserved.
+inline csv_table import(const std::string &filename, const dialect &d, error_log *errors)
+{
+    using namespace parser;
 
-    if (!::parser::no_error(result))
+    csv_table table;
+    head_stat head = estimate_stat(filename, d);
+    if (head.compression == compression::none)
     {
-        throw ::parser::get_error(result);
+        const table_stat &estimate = head.estimate;
+        std::size_t rows = estimate.sampled ? 0 : estimate.rows - (d.header && estimate.rows != 0 ? 1 : 0);
+        table.reserve(rows, estimate.columns, estimate.cell_bytes);
     }
 
-    return csv_table(::parser::get_ast(result));
+    scope s(open_input(filename, head.compression), position());
+
+    return visit_dialect(d, [&](auto fixed) {
+        return import_rows(s, row_scanner(fixed), d.header, errors, std::move(table));
+    });
+}
+} // namespace detail
+
+inline csv_table import_csv(const std::string &filename, const dialect &d = dialects::standard)
+{
+    return detail::import(filename, d, nullptr);
+}
+
+// Lenient import: malformed rows and rows of a wrong width are recorded in
+// `errors` and skipped, parsing resumes at the next unquoted newline.
+inline csv_table import_csv(const std::string &filename, const dialect &d, error_log &errors)
+{
+    return detail::import(filename, d, &errors);
+}
+
+inline csv_table import_csv(const std::string &filename, error_log &errors)
+{
+    return detail::import(filename, dialects::standard, &errors);
 }
 } // namespace csv
 
@@ -5,17 +5,224 @@
 #ifndef CSV_CSV_TABLE_HPP
 #define CSV_CSV_TABLE_HPP
 
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "ast/ast.hpp"
+#include "csv/column_dictionary.hpp"
 
 namespace csv {
 
+namespace detail {
+inline const std::string width_mismatch = "Row length does not correspond to table width";
+} // namespace detail
+
+// Cells of one row, pointing into the table storage. Invalidated by any
+// change of the table.
+class row_view
+{
+  public:
+    class iterator
+    {
+      public:
+        using value_type = std::string_view;
+        using reference = std::string_view;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const char *data, const std::size_t *offset)
+                : data_(data), offset_(offset) {}
+
+        std::string_view operator*() const noexcept
+        {
+            return {data_ + offset_[0], offset_[1] - offset_[0]};
+        }
+
+        iterator &operator++() noexcept
+        {
+            ++offset_;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator old = *this;
+            ++offset_;
+            return old;
+        }
+
+        bool operator==(const iterator &) const = default;
+
+      private:
+        const char *data_ = nullptr;
+        const std::size_t *offset_ = nullptr;
+    };
+
+    row_view(const char *data, const std::size_t *offsets, std::size_t width)
+            : data_(data), offsets_(offsets), width_(width) {}
+
+    [[nodiscard]] std::size_t size() const noexcept { return width_; }
+
+    std::string_view operator[](std::size_t column) const noexcept
+    {
+        return *iterator(data_, offsets_ + column);
+    }
+
+    [[nodiscard]] iterator begin() const noexcept { return {data_, offsets_}; }
+
+    [[nodiscard]] iterator end() const noexcept { return {data_, offsets_ + width_}; }
+
+  private:
+    const char *data_;
+    const std::size_t *offsets_;
+    std::size_t width_;
+};
+
+// Table of strings stored row by row in one contiguous buffer, with the
+// boundaries of every cell kept in a separate offset array.
 class csv_table
 {
   public:
+    // Builds one row in place at the end of the table storage. The row
+    // becomes part of the table on commit() and is discarded otherwise.
+    class row_builder
+    {
+      public:
+        explicit row_builder(csv_table &table)
+                : table_(table),
+                  cells_mark_(table.cells_.size()),
+                  offsets_mark_(table.offsets_.size())
+        {
+        }
+
+        row_builder(const row_builder &) = delete;
+
+        row_builder &operator=(const row_builder &) = delete;
+
+        ~row_builder() { rollback(); }
+
+        void begin_cell()
+        {
+            if (open_)
+            {
+                table_.offsets_.push_back(table_.cells_.size());
+            }
+            open_ = true;
+        }
+
+        void append(char c) { table_.cells_.push_back(c); }
+
+        void append(std::string_view s) { table_.cells_.append(s); }
+
+        // Removes the last `count` characters of the current cell.
+        void drop(std::size_t count) { table_.cells_.resize(table_.cells_.size() - count); }
+
+        // Finishes the row, or discards it if its width does not match.
+        bool commit()
+        {
+            if (open_)
+            {
+                table_.offsets_.push_back(table_.cells_.size());
+                open_ = false;
+            }
+            std::size_t width = table_.offsets_.size() - offsets_mark_;
+            if (width == 0 || (table_.width_ != 0 && table_.width_ != width))
+            {
+                rollback();
+                return false;
+            }
+            table_.width_ = width;
+            cells_mark_ = table_.cells_.size();
+            offsets_mark_ = table_.offsets_.size();
+            return true;
+        }
+
+        void rollback()
+        {
+            table_.cells_.resize(cells_mark_);
+            table_.offsets_.resize(offsets_mark_);
+            open_ = false;
+        }
+
+      private:
+        csv_table &table_;
+        std::size_t cells_mark_;
+        std::size_t offsets_mark_;
+        bool open_ = false;
+    };
+
+    class rows_view
+    {
+      public:
+        class iterator
+        {
+          public:
+            using value_type = row_view;
+            using reference = row_view;
+            using pointer = void;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() = default;
+
+            iterator(const char *data, const std::size_t *offsets, std::size_t width)
+                    : data_(data), offsets_(offsets), width_(width) {}
+
+            row_view operator*() const noexcept { return {data_, offsets_, width_}; }
+
+            iterator &operator++() noexcept
+            {
+                offsets_ += width_;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                iterator old = *this;
+                offsets_ += width_;
+                return old;
+            }
+
+            bool operator==(const iterator &) const = default;
+
+          private:
+            const char *data_ = nullptr;
+            const std::size_t *offsets_ = nullptr;
+            std::size_t width_ = 0;
+        };
+
+        rows_view(const csv_table &table)
+                : table_(table) {}
+
+        [[nodiscard]] iterator begin() const noexcept
+        {
+            return {table_.cells_.data(), table_.offsets_.data(), table_.width_};
+        }
+
+        [[nodiscard]] iterator end() const noexcept
+        {
+            return {table_.cells_.data(), table_.offsets_.data() + table_.offsets_.size() - 1, table_.width_};
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return table_.height(); }
+
+      private:
+        const csv_table &table_;
+    };
+
     csv_table() = default;
 
     explicit csv_table(ast::node_ptr n)
-            : table()
+            : csv_table()
     {
         for (const auto &row_node : ast::nodes(n))
         {
@@ -23,57 +230,172 @@ class csv_table
             {
                 continue;
             }
-            std::vector<std::string> row;
+            row_builder builder(*this);
             for (const auto &cell_node : ast::nodes(row_node))
             {
-                row.push_back(cell_node->get_name());
+                builder.begin_cell();
+                builder.append(cell_node->get_name());
+            }
+            if (!builder.commit())
+            {
+                throw std::logic_error(detail::width_mismatch);
             }
-            add_row(row);
         }
     }
 
     [[nodiscard]] std::size_t height() const noexcept
     {
-        return table.size();
+        return width_ == 0 ? 0 : (offsets_.size() - 1) / width_;
     }
 
     [[nodiscard]] std::size_t width() const noexcept
     {
-        return table.empty() ? 0 : table[0].size();
+        return width_;
     }
 
     [[nodiscard]] bool can_add_row(const std::vector<std::string> &row) const noexcept
     {
-        return table.empty() || table[0].size() == row.size();
+        return width_ == 0 || width_ == row.size();
     }
 
     void add_row(const std::vector<std::string> &row)
     {
-        if (!can_add_row(row))
+        emplace_row(row);
+    }
+
+    // Appends a row from any range of string-like cells, copying each cell
+    // once straight into the table storage.
+    template<std::ranges::input_range Row>
+    requires std::convertible_to<std::ranges::range_reference_t<Row>, std::string_view>
+    void emplace_row(const Row &row)
+    {
+        row_builder builder(*this);
+        for (std::string_view cell : row)
+        {
+            builder.begin_cell();
+            builder.append(cell);
+        }
+        if (!builder.commit())
+        {
+            throw std::logic_error(detail::width_mismatch);
+        }
+    }
+
+    void set_header(const std::vector<std::string> &header)
+    {
+        if (!can_add_row(header))
         {
-            throw std::logic_error("Row length does not correspond to table width");
+            throw std::logic_error(detail::width_mismatch);
         }
-        table.push_back(row);
+        width_ = header.size();
+        header_ = column_dictionary(header);
     }
 
-    [[nodiscard]] const std::vector<std::vector<std::string>> &rows() const noexcept
+    // Turns the first row of a table built without a header into one.
+    void promote_first_row()
     {
-        return table;
+        if (has_header())
+        {
+            throw std::logic_error("Table already has a header");
+        }
+        if (height() == 0)
+        {
+            throw std::logic_error("Table has no rows to use as a header");
+        }
+        header_ = column_dictionary(row(0));
+        std::size_t header_bytes = offsets_[width_];
+        cells_.erase(0, header_bytes);
+        offsets_.erase(offsets_.begin(), offsets_.begin() + static_cast<std::ptrdiff_t>(width_));
+        for (std::size_t &offset : offsets_)
+        {
+            offset -= header_bytes;
+        }
+    }
+
+    [[nodiscard]] bool has_header() const noexcept { return !header_.empty(); }
+
+    [[nodiscard]] const column_dictionary &header() const noexcept
+    {
+        return header_;
+    }
+
+    [[nodiscard]] std::optional<std::size_t> find_column(std::string_view name) const
+    {
+        return header_.find(name);
+    }
+
+    // Index of the named column. Resolve it once and access cells by index
+    // in loops over rows.
+    [[nodiscard]] std::size_t column(std::string_view name) const
+    {
+        return header_.index(name);
+    }
+
+    // Preallocates storage for `rows` rows of `columns` cells holding
+    // `cell_bytes` characters in total.
+    void reserve(std::size_t rows, std::size_t columns, std::size_t cell_bytes)
+    {
+        offsets_.reserve(rows * columns + 1);
+        cells_.reserve(cell_bytes);
+    }
+
+    [[nodiscard]] std::string_view cell(std::size_t row, std::size_t column) const noexcept
+    {
+        std::size_t index = row * width_ + column;
+        return {cells_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]};
+    }
+
+    [[nodiscard]] std::string_view cell(std::size_t row, std::string_view column) const
+    {
+        return cell(row, this->column(column));
+    }
+
+    [[nodiscard]] row_view row(std::size_t row) const noexcept
+    {
+        return {cells_.data(), offsets_.data() + row * width_, width_};
+    }
+
+    row_view operator[](std::size_t row) const noexcept { return this->row(row); }
+
+    [[nodiscard]] rows_view rows() const noexcept
+    {
+        return rows_view(*this);
+    }
+
+    bool operator==(const csv_table &other) const
+    {
+        return width_ == other.width_ && header_ == other.header_ &&
+               offsets_ == other.offsets_ && cells_ == other.cells_;
     }
 
   private:
-    std::vector<std::vector<std::string>> table;
+    std::string cells_{};
+    std::vector<std::size_t> offsets_{0};
+    std::size_t width_ = 0;
+    column_dictionary header_{};
 };
 
-std::ostream &operator<<(std::ostream &os, const csv_table &table)
+namespace detail {
+template<typename Row>
+void print_row(std::ostream &os, const Row &row)
 {
-    for (const auto &row : table.rows())
+    for (std::string_view s : row)
     {
-        for (const std::string &s : row)
-        {
-            os << '\'' << s << '\'' << ' ';
-        }
-        os << '\n';
+        os << '\'' << s << '\'' << ' ';
+    }
+    os << '\n';
+}
+} // namespace detail
+
+inline std::ostream &operator<<(std::ostream &os, const csv_table &table)
+{
+    if (table.has_header())
+    {
+        detail::print_row(os, table.header());
+    }
+    for (row_view row : table.rows())
+    {
+        detail::print_row(os, row);
     }
     return os;
 }
@@ -0,0 +1,90 @@
+#ifndef CSV_DIALECT_HPP
+#define CSV_DIALECT_HPP
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace csv {
+
+enum class line_terminator
+{
+    lf,
+    crlf,
+    any // either "\n" or "\r\n"
+};
+
+// Describes the flavour of a delimited file. A zero `quote` disables quoted
+// cells, a zero `escape` disables escaping inside them. When `escape` equals
+// `quote` a doubled quote stands for a literal one.
+struct dialect
+{
+    char delimiter = ',';
+    char quote = '"';
+    char escape = '"';
+    line_terminator terminator = line_terminator::any;
+    bool header = false;
+    bool trim = false;
+
+    bool operator==(const dialect &) const = default;
+};
+
+namespace dialects {
+inline constexpr dialect standard{};
+inline constexpr dialect rfc4180{.terminator = line_terminator::crlf};
+inline constexpr dialect semicolon{.delimiter = ';'};
+inline constexpr dialect tsv{.delimiter = '\t', .quote = '\0', .escape = '\0'};
+} // namespace dialects
+
+inline constexpr std::pair<const char *, dialect> named_dialects[] = {
+        {"standard", dialects::standard},
+        {"rfc4180", dialects::rfc4180},
+        {"semicolon", dialects::semicolon},
+        {"tsv", dialects::tsv},
+};
+
+inline dialect dialect_by_name(const std::string &name)
+{
+    std::string known;
+    for (const auto &[known_name, d] : named_dialects)
+    {
+        if (name == known_name)
+            return d;
+        known += known.empty() ? known_name : std::string(", ") + known_name;
+    }
+    throw std::invalid_argument("Unknown dialect '" + name + "', expected one of: " + known);
+}
+
+// Dialect known at compile time: every comparison against it folds into an
+// immediate, so the scanner specialised with it pays nothing per byte.
+template<dialect D>
+struct fixed_dialect
+{
+    static constexpr dialect get() noexcept { return D; }
+};
+
+struct runtime_dialect
+{
+    dialect value;
+
+    [[nodiscard]] constexpr dialect get() const noexcept { return value; }
+};
+
+// Calls `f` with a fixed_dialect if `d` matches one of the common dialects
+// and with a runtime_dialect otherwise. The header flag does not affect
+// scanning and is ignored for matching.
+template<typename F>
+decltype(auto) visit_dialect(const dialect &d, F &&f)
+{
+    dialect scanning = d;
+    scanning.header = false;
+    if (scanning == dialects::standard) return std::forward<F>(f)(fixed_dialect<dialects::standard>{});
+    if (scanning == dialects::rfc4180) return std::forward<F>(f)(fixed_dialect<dialects::rfc4180>{});
+    if (scanning == dialects::semicolon) return std::forward<F>(f)(fixed_dialect<dialects::semicolon>{});
+    if (scanning == dialects::tsv) return std::forward<F>(f)(fixed_dialect<dialects::tsv>{});
+    return std::forward<F>(f)(runtime_dialect{d});
+}
+
+} // namespace csv
+
+#endif //CSV_DIALECT_HPP
@@ -0,0 +1,70 @@
+#ifndef CSV_ERROR_LOG_HPP
+#define CSV_ERROR_LOG_HPP
+
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exception/exception.hpp"
+#include "parser/position.hpp"
+
+namespace csv {
+
+struct row_error
+{
+    parser::position pos; // start of the row
+    std::string reason;
+    // Where a row that does not parse stopped matching.
+    std::optional<parser::position> at{};
+};
+
+// Not a parse error itself: the rows that were rejected stay in the
+// error_log that threw it.
+class error_budget_exceeded : public std::runtime_error
+{
+  public:
+    explicit error_budget_exceeded(std::size_t budget)
+            : std::runtime_error("More than " + std::to_string(budget) + " malformed rows") {}
+};
+
+// Side list of rows skipped by a lenient import. Once more than `budget`
+// rows were rejected the import is aborted with error_budget_exceeded; the
+// rows recorded until then are kept.
+class error_log
+{
+  public:
+    static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+    explicit error_log(std::size_t budget = unlimited)
+            : budget_(budget) {}
+
+    void record(const parser::position &pos, std::string reason,
+                std::optional<parser::position> at = std::nullopt)
+    {
+        if (errors_.size() >= budget_)
+        {
+            throw error_budget_exceeded(budget_);
+        }
+        errors_.push_back(row_error{pos, std::move(reason), std::move(at)});
+    }
+
+    [[nodiscard]] std::size_t budget() const noexcept { return budget_; }
+
+    [[nodiscard]] bool empty() const noexcept { return errors_.empty(); }
+
+    [[nodiscard]] const std::vector<row_error> &errors() const noexcept
+    {
+        return errors_;
+    }
+
+  private:
+    std::size_t budget_;
+    std::vector<row_error> errors_{};
+};
+
+} // namespace csv
+
+#endif //CSV_ERROR_LOG_HPP
@@ -0,0 +1,352 @@
+#ifndef CSV_EXPORT_HPP
+#define CSV_EXPORT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csv/stream.hpp"
+
+// Stream handlers converting rows to other formats as they are parsed. Each
+// writer buffers a bounded amount of output; call finish() after the last
+// row.
+namespace csv {
+
+namespace detail {
+inline constexpr std::size_t flush_bytes = 1 << 20;
+
+inline void append_json_string(std::string &out, std::string_view s)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : s)
+    {
+        switch (c)
+        {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out.append("\\u00");
+                    out.push_back(hex[c >> 4]);
+                    out.push_back(hex[c & 0xf]);
+                } else
+                {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+} // namespace detail
+
+// One JSON value per line: an object keyed by the header names when the
+// dialect has a header, an array of strings otherwise.
+class jsonl_writer
+{
+  public:
+    explicit jsonl_writer(std::ostream &out)
+            : out_(out) {}
+
+    template<typename Names>
+    void header(const Names &names)
+    {
+        keys_.clear();
+        for (std::string_view name : names)
+        {
+            keys_.emplace_back();
+            detail::append_json_string(keys_.back(), name);
+            keys_.back().push_back(':');
+        }
+    }
+
+    void row(row_view cells)
+    {
+        bool object = !keys_.empty();
+        buffer_.push_back(object ? '{' : '[');
+        for (std::size_t column = 0; column < cells.size(); ++column)
+        {
+            if (column != 0)
+            {
+                buffer_.push_back(',');
+            }
+            if (object)
+            {
+                buffer_.append(keys_[column]);
+            }
+            detail::append_json_string(buffer_, cells[column]);
+        }
+        buffer_.append(object ? "}\n" : "]\n");
+        if (buffer_.size() >= detail::flush_bytes)
+        {
+            flush();
+        }
+    }
+
+    void finish()
+    {
+        flush();
+        out_.flush();
+    }
+
+  private:
+    void flush()
+    {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+    std::ostream &out_;
+    std::vector<std::string> keys_{};
+    std::string buffer_{};
+};
+
+// Binary columnar format, all integers in native byte order:
+//
+//   file:   "CSVCOL01", u64 flags (bit 0: has header), u64 columns,
+//           columns x (u32 name length, name), row groups, u64 0
+//   group:  u64 rows, columns x (u64 bytes, rows x u32 cell end, bytes)
+//
+// Names are empty without a header. A row group holds at most `group_rows`
+// rows, and is closed early once its cells take `group_bytes`, which bounds
+// the memory of the writer.
+class columnar_writer
+{
+  public:
+    static constexpr char magic[8] = {'C', 'S', 'V', 'C', 'O', 'L', '0', '1'};
+    static constexpr std::size_t default_group_rows = 1 << 16;
+    static constexpr std::size_t group_bytes = 1 << 26;
+
+    explicit columnar_writer(std::ostream &out, std::size_t group_rows = default_group_rows)
+            : out_(out), group_rows_(group_rows == 0 ? 1 : group_rows) {}
+
+    template<typename Names>
+    void header(const Names &names)
+    {
+        write_file_header(names, true);
+    }
+
+    void row(row_view cells)
+    {
+        if (!started_)
+        {
+            write_file_header(cells, false);
+        }
+        for (std::size_t column = 0; column < cells.size(); ++column)
+        {
+            columns_[column].bytes.append(cells[column]);
+            columns_[column].ends.push_back(static_cast<std::uint32_t>(columns_[column].bytes.size()));
+            buffered_ += cells[column].size();
+        }
+        if (++rows_ == group_rows_ || buffered_ >= group_bytes)
+        {
+            write_group();
+        }
+    }
+
+    void finish()
+    {
+        if (!started_)
+        {
+            write_file_header(row_view(nullptr, nullptr, 0), false);
+        }
+        write_group();
+        write(0);
+        out_.flush();
+    }
+
+  private:
+    struct column
+    {
+        std::string bytes;
+        std::vector<std::uint32_t> ends;
+    };
+
+    template<typename Names>
+    void write_file_header(const Names &names, bool has_header)
+    {
+        started_ = true;
+        columns_.resize(names.size());
+        out_.write(magic, sizeof(magic));
+        write(has_header ? 1 : 0);
+        write(names.size());
+        for (std::string_view name : names)
+        {
+            auto length = static_cast<std::uint32_t>(has_header ? name.size() : 0);
+            out_.write(reinterpret_cast<const char *>(&length), sizeof(length));
+            out_.write(name.data(), length);
+        }
+    }
+
+    void write_group()
+    {
+        if (rows_ == 0)
+        {
+            return;
+        }
+        write(rows_);
+        for (column &c : columns_)
+        {
+            write(c.bytes.size());
+            out_.write(reinterpret_cast<const char *>(c.ends.data()),
+                       static_cast<std::streamsize>(c.ends.size() * sizeof(std::uint32_t)));
+            out_.write(c.bytes.data(), static_cast<std::streamsize>(c.bytes.size()));
+            c.bytes.clear();
+            c.ends.clear();
+        }
+        rows_ = 0;
+        buffered_ = 0;
+    }
+
+    void write(std::uint64_t value)
+    {
+        out_.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    std::ostream &out_;
+    std::size_t group_rows_;
+    bool started_ = false;
+    std::vector<column> columns_{};
+    std::size_t rows_ = 0;
+    std::size_t buffered_ = 0;
+};
+
+inline void export_jsonl(const std::string &filename, const dialect &d, std::ostream &out)
+{
+    jsonl_writer writer(out);
+    stream_csv(filename, d, writer);
+    writer.finish();
+}
+
+inline void export_columnar(const std::string &filename, const dialect &d, std::ostream &out)
+{
+    columnar_writer writer(out);
+    stream_csv(filename, d, writer);
+    writer.finish();
+}
+
+// Reads a file written by columnar_writer back into a table.
+inline csv_table import_columnar(const std::string &filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    auto malformed = [&] { return parser::input_reading_error(filename, "not a columnar file"); };
+    auto read = [&](auto &value) {
+        in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    };
+
+    char file_magic[sizeof(columnar_writer::magic)];
+    if (!in.read(file_magic, sizeof(file_magic)) ||
+        std::memcmp(file_magic, columnar_writer::magic, sizeof(file_magic)) != 0)
+    {
+        throw malformed();
+    }
+    // Every count is checked against the bytes left in the file before
+    // anything is allocated for it, so a corrupt file can not ask for more
+    // memory than its own size.
+    const std::uint64_t file_size = std::filesystem::file_size(filename);
+    auto left = [&]() -> std::uint64_t {
+        std::streamoff here = in.tellg();
+        return here < 0 || static_cast<std::uint64_t>(here) > file_size ? 0 : file_size - here;
+    };
+
+    std::uint64_t flags = 0, columns = 0;
+    read(flags);
+    read(columns);
+    if (!in || columns > left() / sizeof(std::uint32_t))
+    {
+        throw malformed();
+    }
+    std::vector<std::string> names(columns);
+    for (std::string &name : names)
+    {
+        std::uint32_t length = 0;
+        read(length);
+        if (!in || length > left())
+        {
+            throw malformed();
+        }
+        name.resize(length);
+        in.read(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+
+    csv_table table;
+    if (flags & 1)
+    {
+        table.set_header(names);
+    }
+    std::vector<std::vector<std::uint32_t>> ends(names.size());
+    std::vector<std::string> bytes(names.size());
+    std::vector<std::string_view> row(names.size());
+    std::uint64_t rows = 0;
+    while (read(rows), in && rows != 0)
+    {
+        if (names.empty())
+        {
+            throw malformed();
+        }
+        for (std::size_t c = 0; c < names.size(); ++c)
+        {
+            std::uint64_t size = 0;
+            read(size);
+            if (!in || rows > left() / sizeof(std::uint32_t))
+            {
+                throw malformed();
+            }
+            ends[c].resize(rows);
+            in.read(reinterpret_cast<char *>(ends[c].data()),
+                    static_cast<std::streamsize>(ends[c].size() * sizeof(std::uint32_t)));
+            if (!in || size > left())
+            {
+                throw malformed();
+            }
+            bytes[c].resize(size);
+            in.read(bytes[c].data(), static_cast<std::streamsize>(bytes[c].size()));
+            if (!in || ends[c].back() != size)
+            {
+                throw malformed();
+            }
+        }
+        for (std::size_t r = 0; r < rows; ++r)
+        {
+            for (std::size_t c = 0; c < names.size(); ++c)
+            {
+                std::uint32_t begin = r == 0 ? 0 : ends[c][r - 1];
+                if (ends[c][r] < begin)
+                {
+                    throw malformed();
+                }
+                row[c] = std::string_view(bytes[c]).substr(begin, ends[c][r] - begin);
+            }
+            table.emplace_row(row);
+        }
+    }
+    if (!in)
+    {
+        throw malformed();
+    }
+    return table;
+}
+
+} // namespace csv
+
+#endif //CSV_EXPORT_HPP
@@ -0,0 +1,338 @@
+#ifndef CSV_INDEX_HPP
+#define CSV_INDEX_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "csv/csv_parser.hpp"
+
+namespace csv {
+
+// Identifies the file and dialect an index was built for, so that a stale
+// sidecar is rebuilt instead of used.
+struct index_signature
+{
+    std::uint64_t file_size = 0;
+    std::int64_t modified = 0;
+    dialect format{};
+
+    static index_signature of(const std::string &path, const dialect &d)
+    {
+        index_signature signature;
+        signature.file_size = std::filesystem::file_size(path);
+        signature.modified = std::filesystem::last_write_time(path).time_since_epoch().count();
+        signature.format = d;
+        return signature;
+    }
+
+    bool operator==(const index_signature &) const = default;
+};
+
+// Sparse index of row start offsets: one entry for every `stride` rows.
+class row_index
+{
+  public:
+    static constexpr std::size_t default_stride = 1024;
+
+    explicit row_index(std::size_t stride = default_stride)
+            : stride_(stride == 0 ? 1 : stride) {}
+
+    void add_row(std::size_t offset)
+    {
+        if (rows_ % stride_ == 0)
+        {
+            offsets_.push_back(offset);
+        }
+        ++rows_;
+    }
+
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+
+    [[nodiscard]] std::size_t stride() const noexcept { return stride_; }
+
+    // Offset of the closest indexed row at or before `row`.
+    [[nodiscard]] std::size_t offset(std::size_t row) const { return offsets_.at(row / stride_); }
+
+    void save(const std::string &index_path, const index_signature &signature) const
+    {
+        std::ofstream out(index_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            throw std::runtime_error("Can not write index " + index_path);
+        }
+        out.write(magic, sizeof(magic));
+        write(out, signature.file_size);
+        write(out, static_cast<std::uint64_t>(signature.modified));
+        const dialect &d = signature.format;
+        const char format[8] = {d.delimiter, d.quote, d.escape, static_cast<char>(d.terminator),
+                                static_cast<char>(d.header), static_cast<char>(d.trim)};
+        out.write(format, sizeof(format));
+        write(out, stride_);
+        write(out, rows_);
+        write(out, offsets_.size());
+        out.write(reinterpret_cast<const char *>(offsets_.data()),
+                  static_cast<std::streamsize>(offsets_.size() * sizeof(std::uint64_t)));
+    }
+
+    // Returns nothing if there is no index or it was built for another
+    // version of the file or another dialect.
+    static std::optional<row_index> load(const std::string &index_path, const index_signature &signature)
+    {
+        std::ifstream in(index_path, std::ios::binary);
+        char file_magic[sizeof(magic)];
+        if (!in.read(file_magic, sizeof(file_magic)) || std::memcmp(file_magic, magic, sizeof(magic)) != 0)
+        {
+            return std::nullopt;
+        }
+        index_signature stored;
+        stored.file_size = read(in);
+        stored.modified = static_cast<std::int64_t>(read(in));
+        char format[8];
+        in.read(format, sizeof(format));
+        stored.format = dialect{format[0], format[1], format[2], static_cast<line_terminator>(format[3]),
+                                format[4] != 0, format[5] != 0};
+        if (!in || !(stored == signature))
+        {
+            return std::nullopt;
+        }
+        row_index index(read(in));
+        index.rows_ = read(in);
+        std::uint64_t count = read(in);
+        // Checked before allocating, so that a corrupt index can not ask
+        // for more memory than the file could hold.
+        if (!in || count != (index.rows_ + index.stride_ - 1) / index.stride_ ||
+            count > remaining(in) / sizeof(std::uint64_t))
+        {
+            return std::nullopt;
+        }
+        index.offsets_.resize(count);
+        in.read(reinterpret_cast<char *>(index.offsets_.data()),
+                static_cast<std::streamsize>(index.offsets_.size() * sizeof(std::uint64_t)));
+        if (!in)
+        {
+            return std::nullopt;
+        }
+        return index;
+    }
+
+  private:
+    static constexpr char magic[8] = {'C', 'S', 'V', 'I', 'D', 'X', '0', '1'};
+
+    static void write(std::ostream &out, std::uint64_t value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    static std::uint64_t read(std::istream &in)
+    {
+        std::uint64_t value = 0;
+        in.read(reinterpret_cast<char *>(&value), sizeof(value));
+        return value;
+    }
+
+    // Bytes between the read position and the end of the stream.
+    static std::uint64_t remaining(std::istream &in)
+    {
+        std::streampos here = in.tellg();
+        in.seekg(0, std::ios::end);
+        std::streampos end = in.tellg();
+        in.seekg(here);
+        return here < 0 || end < here ? 0 : static_cast<std::uint64_t>(end - here);
+    }
+
+    std::size_t stride_;
+    std::size_t rows_ = 0;
+    std::vector<std::uint64_t> offsets_{};
+};
+
+inline std::string index_path(const std::string &path) { return path + ".idx"; }
+
+namespace detail {
+// Parses the whole file once, recording the start of every row. Cells are
+// only checked, not kept.
+template<typename DialectT>
+row_index build_index(parser::scope &sc, const row_scanner<DialectT> &scanner, std::size_t stride)
+{
+    row_index index(stride);
+    detail::null_sink ignored;
+    while (sc.has_next())
+    {
+        parser::position start = sc.pos;
+        sc.reader->discard_before(start);
+        if (scanner.scan(sc, ignored))
+        {
+            throw parser::exception::positional_error(start, "'EOF' is expected here");
+        }
+        index.add_row(start.get_abs_pos());
+    }
+    return index;
+}
+} // namespace detail
+
+// Random access to the rows of a file through its row index: row(i) reads
+// from the closest indexed offset and parses at most `stride` rows.
+class indexed_csv
+{
+  public:
+    indexed_csv(std::string path, const dialect &d, row_index index)
+            : path_(std::move(path)), dialect_(d), index_(std::move(index))
+    {
+        if (dialect_.header && index_.rows() != 0)
+        {
+            header_ = column_dictionary(parse_row(0));
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return index_.rows() - (dialect_.header && index_.rows() != 0 ? 1 : 0);
+    }
+
+    [[nodiscard]] const column_dictionary &header() const noexcept { return header_; }
+
+    [[nodiscard]] std::size_t column(std::string_view name) const { return header_.index(name); }
+
+    [[nodiscard]] const row_index &index() const noexcept { return index_; }
+
+    [[nodiscard]] std::vector<std::string> row(std::size_t i) const
+    {
+        if (i >= size())
+        {
+            throw std::out_of_range("Row " + std::to_string(i) + " is out of range");
+        }
+        return parse_row(i + (dialect_.header ? 1 : 0));
+    }
+
+    // Builds a hash index over the values of one column, replacing the
+    // previous one. A column outside the first row throws std::out_of_range.
+    void index_column(std::size_t column)
+    {
+        std::size_t width = index_.rows() == 0 ? 0 : parse_row(0).size();
+        if (column >= width)
+        {
+            throw std::out_of_range("Column " + std::to_string(column) + " is out of range for a table of width " +
+                                    std::to_string(width));
+        }
+        key_column_ = column;
+        keys_.clear();
+        for_each_row([&](std::size_t row, const std::vector<std::string> &cells) {
+            if (column < cells.size())
+            {
+                keys_[cells[column]].push_back(row);
+            }
+        });
+    }
+
+    void index_column(std::string_view name) { index_column(column(name)); }
+
+    [[nodiscard]] std::optional<std::size_t> key_column() const noexcept { return key_column_; }
+
+    // Rows whose indexed column equals `key`, in file order.
+    [[nodiscard]] const std::vector<std::size_t> &find(const std::string &key) const
+    {
+        static const std::vector<std::size_t> none;
+        if (!key_column_)
+        {
+            throw std::logic_error("No column is indexed");
+        }
+        auto it = keys_.find(key);
+        return it == keys_.end() ? none : it->second;
+    }
+
+  private:
+    [[nodiscard]] std::vector<std::string> parse_row(std::size_t physical) const
+    {
+        parser::scope sc(std::make_shared<parser::offset_file_reader>(path_, index_.offset(physical)),
+                         parser::position());
+        return visit_dialect(dialect_, [&](auto fixed) {
+            row_scanner scanner(fixed);
+            detail::null_sink ignored;
+            for (std::size_t skip = physical % index_.stride(); skip != 0; --skip)
+            {
+                if (auto error = scanner.scan(sc, ignored))
+                {
+                    throw *error;
+                }
+            }
+            std::vector<std::string> cells;
+            if (auto error = scanner.scan(sc, cells))
+            {
+                throw *error;
+            }
+            return cells;
+        });
+    }
+
+    template<typename F>
+    void for_each_row(F &&f) const
+    {
+        parser::scope sc(detail::open_input(path_), parser::position());
+        visit_dialect(dialect_, [&](auto fixed) {
+            row_scanner scanner(fixed);
+            std::vector<std::string> cells;
+            std::size_t physical = 0;
+            while (sc.has_next())
+            {
+                sc.reader->discard_before(sc.pos);
+                if (auto error = scanner.scan(sc, cells))
+                {
+                    throw *error;
+                }
+                if (physical != 0 || !dialect_.header)
+                {
+                    f(physical - (dialect_.header ? 1 : 0), cells);
+                }
+                ++physical;
+            }
+        });
+    }
+
+    std::string path_;
+    dialect dialect_;
+    row_index index_;
+    column_dictionary header_{};
+    std::optional<std::size_t> key_column_{};
+    std::unordered_map<std::string, std::vector<std::size_t>> keys_{};
+};
+
+// Opens a file for random row access. The row index is read from the
+// `<path>.idx` sidecar if it matches the file, otherwise it is built by
+// parsing the file and persisted next to it. import_csv() does not write
+// the sidecar, so the first open_indexed() of a file is a pass of its own.
+inline indexed_csv open_indexed(const std::string &path, const dialect &d = dialects::standard,
+                                std::size_t stride = row_index::default_stride)
+{
+    if (parser::detect_compression(path) != parser::compression::none)
+    {
+        throw parser::input_reading_error(path, "compressed files can not be indexed");
+    }
+    index_signature signature = index_signature::of(path, d);
+    std::optional<row_index> index = row_index::load(index_path(path), signature);
+    if (!index || index->stride() != stride)
+    {
+        parser::scope sc(detail::open_input(path), parser::position());
+        index = visit_dialect(d, [&](auto fixed) {
+            return detail::build_index(sc, row_scanner(fixed), stride);
+        });
+        try
+        {
+            index->save(index_path(path), signature);
+        } catch (const std::runtime_error &)
+        {
+            // A read-only location only costs rebuilding the index next time.
+        }
+    }
+    return indexed_csv(path, d, std::move(*index));
+}
+
+} // namespace csv
+
+#endif //CSV_INDEX_HPP
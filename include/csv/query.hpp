@@ -0,0 +1,269 @@
+#ifndef CSV_QUERY_HPP
+#define CSV_QUERY_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "csv/csv_table.hpp"
+
+// Aggregates over the columns of a csv_table. Columns are addressed by index;
+// resolve names once with csv_table::column(). An index outside the table
+// throws std::out_of_range. Cells that are not numbers are skipped by the
+// numeric aggregates, like NULLs in SQL.
+namespace csv::query {
+
+struct aggregate
+{
+    std::size_t count = 0;
+    double sum = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double value) noexcept
+    {
+        ++count;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(const aggregate &other) noexcept
+    {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    [[nodiscard]] double mean() const noexcept
+    {
+        return count == 0 ? std::numeric_limits<double>::quiet_NaN() : sum / static_cast<double>(count);
+    }
+};
+
+namespace detail {
+inline constexpr std::size_t lanes = 8;
+inline constexpr std::size_t block_rows = 1024;
+inline constexpr std::size_t min_rows_per_thread = 1 << 16;
+
+inline double to_number(std::string_view cell) noexcept
+{
+    double value = std::numeric_limits<double>::quiet_NaN();
+    auto result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+    if (result.ec != std::errc() || result.ptr != cell.data() + cell.size())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value;
+}
+
+// Cells are read without bounds checks, so every column index is checked
+// once before the work is handed to the threads.
+inline void check_column(const csv_table &table, std::size_t column)
+{
+    if (column >= table.width())
+    {
+        throw std::out_of_range("Column " + std::to_string(column) + " is out of range for a table of width " +
+                                std::to_string(table.width()));
+    }
+}
+
+inline unsigned thread_count(std::size_t rows, unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t useful = std::max<std::size_t>(1, rows / min_rows_per_thread);
+    return static_cast<unsigned>(std::min<std::size_t>(threads, useful));
+}
+
+// Splits [0, rows) into one contiguous range per thread, runs
+// `f(begin, end)` on each and returns the partial results in order.
+template<typename F>
+auto parallel_ranges(std::size_t rows, unsigned threads, F &&f)
+{
+    using partial = decltype(f(std::size_t{}, std::size_t{}));
+    unsigned count = thread_count(rows, threads);
+    std::vector<partial> partials(count);
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < count; ++i)
+    {
+        workers.emplace_back([&, i] { partials[i] = f(rows * i / count, rows * (i + 1) / count); });
+    }
+    partials[0] = f(0, rows / count);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    return partials;
+}
+} // namespace detail
+
+// Aggregate of a contiguous array, NaNs skipped. Independent accumulator
+// lanes break the dependency chain so the loop compiles to SIMD code.
+inline aggregate summarize(std::span<const double> values) noexcept
+{
+    std::array<double, detail::lanes> sum{}, min{}, max{}, count{};
+    min.fill(std::numeric_limits<double>::infinity());
+    max.fill(-std::numeric_limits<double>::infinity());
+
+    std::size_t i = 0;
+    for (; i + detail::lanes <= values.size(); i += detail::lanes)
+    {
+        for (std::size_t lane = 0; lane < detail::lanes; ++lane)
+        {
+            double value = values[i + lane];
+            bool valid = value == value;
+            sum[lane] += valid ? value : 0.0;
+            count[lane] += valid ? 1.0 : 0.0;
+            min[lane] = valid && value < min[lane] ? value : min[lane];
+            max[lane] = valid && value > max[lane] ? value : max[lane];
+        }
+    }
+
+    aggregate result;
+    for (std::size_t lane = 0; lane < detail::lanes; ++lane)
+    {
+        result.count += static_cast<std::size_t>(count[lane]);
+        result.sum += sum[lane];
+        result.min = std::min(result.min, min[lane]);
+        result.max = std::max(result.max, max[lane]);
+    }
+    for (; i < values.size(); ++i)
+    {
+        if (values[i] == values[i])
+        {
+            result.add(values[i]);
+        }
+    }
+    return result;
+}
+
+// The column converted to numbers, NaN where a cell is not a number.
+inline std::vector<double> numeric_column(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    detail::check_column(table, column);
+    std::vector<double> values(table.height());
+    detail::parallel_ranges(table.height(), threads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t row = begin; row < end; ++row)
+        {
+            values[row] = detail::to_number(table.cell(row, column));
+        }
+        return 0;
+    });
+    return values;
+}
+
+// Converts and aggregates the column block by block, so that the values
+// stay in cache between the two steps.
+inline aggregate summarize(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    detail::check_column(table, column);
+    auto partials = detail::parallel_ranges(table.height(), threads, [&](std::size_t begin, std::size_t end) {
+        std::array<double, detail::block_rows> block{};
+        aggregate result;
+        for (std::size_t row = begin; row < end; row += detail::block_rows)
+        {
+            std::size_t size = std::min(detail::block_rows, end - row);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                block[i] = detail::to_number(table.cell(row + i, column));
+            }
+            result.merge(summarize(std::span<const double>(block.data(), size)));
+        }
+        return result;
+    });
+    aggregate result;
+    for (const aggregate &partial : partials)
+    {
+        result.merge(partial);
+    }
+    return result;
+}
+
+inline double sum(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    return summarize(table, column, threads).sum;
+}
+
+inline double min(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    return summarize(table, column, threads).min;
+}
+
+inline double max(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    return summarize(table, column, threads).max;
+}
+
+inline std::size_t count(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    return summarize(table, column, threads).count;
+}
+
+inline std::size_t count_distinct(const csv_table &table, std::size_t column, unsigned threads = 0)
+{
+    detail::check_column(table, column);
+    auto partials = detail::parallel_ranges(table.height(), threads, [&](std::size_t begin, std::size_t end) {
+        std::unordered_set<std::string_view> seen;
+        for (std::size_t row = begin; row < end; ++row)
+        {
+            seen.insert(table.cell(row, column));
+        }
+        return seen;
+    });
+    std::unordered_set<std::string_view> seen = std::move(partials.front());
+    for (std::size_t i = 1; i < partials.size(); ++i)
+    {
+        seen.insert(partials[i].begin(), partials[i].end());
+    }
+    return seen.size();
+}
+
+// Aggregates of the `value` column for every distinct cell of the `key`
+// column. Keys point into the table and are valid while it is unchanged.
+inline std::unordered_map<std::string_view, aggregate>
+group_by(const csv_table &table, std::size_t key, std::size_t value, unsigned threads = 0)
+{
+    detail::check_column(table, key);
+    detail::check_column(table, value);
+    using groups = std::unordered_map<std::string_view, aggregate>;
+    auto partials = detail::parallel_ranges(table.height(), threads, [&](std::size_t begin, std::size_t end) {
+        groups result;
+        for (std::size_t row = begin; row < end; ++row)
+        {
+            double number = detail::to_number(table.cell(row, value));
+            aggregate &group = result[table.cell(row, key)];
+            if (number == number)
+            {
+                group.add(number);
+            }
+        }
+        return result;
+    });
+    groups result = std::move(partials.front());
+    for (std::size_t i = 1; i < partials.size(); ++i)
+    {
+        for (const auto &[group_key, group] : partials[i])
+        {
+            result[group_key].merge(group);
+        }
+    }
+    return result;
+}
+
+} // namespace csv::query
+
+#endif //CSV_QUERY_HPP
@@ -0,0 +1,283 @@
+#ifndef CSV_ROW_SCANNER_HPP
+#define CSV_ROW_SCANNER_HPP
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "csv/dialect.hpp"
+#include "exception/exception.hpp"
+#include "parser/scope.hpp"
+
+namespace csv {
+
+namespace detail {
+inline const std::string unclosed_quote = "Quote is not closed before the end of input";
+
+// Receives the cells of a row from the scanner into a vector of strings.
+// csv_table::row_builder is the other sink, writing into table storage.
+class vector_sink
+{
+  public:
+    explicit vector_sink(std::vector<std::string> &cells)
+            : cells_(cells)
+    {
+        cells_.clear();
+    }
+
+    void begin_cell() { cells_.emplace_back(); }
+
+    void append(char c) { cells_.back().push_back(c); }
+
+    void drop(std::size_t count) { cells_.back().resize(cells_.back().size() - count); }
+
+  private:
+    std::vector<std::string> &cells_;
+};
+// Accepts the cells of a row and keeps nothing, for rows that are only
+// passed over.
+struct null_sink
+{
+    static constexpr bool keeps_input = false;
+
+    void begin_cell() {}
+
+    void append(char) {}
+
+    void drop(std::size_t) {}
+};
+
+// Sinks declaring `keeps_input = false` never need to read back what the
+// scanner consumed, so the reader may drop it even in the middle of a row.
+template<typename Sink>
+constexpr bool keeps_input()
+{
+    if constexpr (requires { Sink::keeps_input; })
+        return Sink::keeps_input;
+    else
+        return true;
+}
+} // namespace detail
+
+// Hand-written equivalent of csv_row_parser(): accepts exactly the same rows
+// and produces the same cells, but reads characters straight into the cell
+// strings instead of building a tree per character.
+template<typename DialectT>
+class row_scanner
+{
+  public:
+    using error = parser::exception::positional_error;
+
+    explicit row_scanner(DialectT dialect = {})
+            : dialect_(dialect) {}
+
+    // How far skip() follows a quoted cell past the first line of a
+    // malformed row before resyncing at that line instead, so that a quote
+    // that is never closed does not make every malformed row after it read
+    // the rest of the input.
+    static constexpr std::size_t max_quoted_lookahead = 1 << 24;
+
+    // Interval at which a long quoted cell scanned into a sink that keeps
+    // nothing lets the reader drop the consumed input.
+    static constexpr std::size_t discard_interval = 1 << 16;
+
+    // Reads one row including its line terminator, passing its cells to the
+    // sink. On failure the scope is left at the point where the row stopped
+    // matching.
+    template<typename Sink>
+    std::optional<error> scan(parser::scope &sc, Sink &sink) const
+    {
+        const dialect d = dialect_.get();
+        while (true)
+        {
+            sink.begin_cell();
+            if (auto err = scan_cell(sc, sink))
+                return err;
+
+            if (!sc.has_next())
+                return sc.raise_eof();
+            char c = sc.peek_char();
+            if (c == d.delimiter)
+            {
+                sc.next_char();
+                continue;
+            }
+            return scan_terminator(sc);
+        }
+    }
+
+    std::optional<error> scan(parser::scope &sc, std::vector<std::string> &cells) const
+    {
+        detail::vector_sink sink(cells);
+        return scan(sc, sink);
+    }
+
+    // Moves the scope past the next line terminator which is not inside a
+    // quoted cell. A quote opens a cell only at the start of a field, after
+    // blanks if the dialect trims them, so a stray quote in a malformed row
+    // does not swallow the rest of the file. Escaped characters are part of
+    // their quoted cell, as in scan().
+    // If a quote is still open at the end of the input, or more than
+    // max_quoted_lookahead bytes past the first line terminator of the row,
+    // the scope resumes after that terminator instead and false is returned.
+    // With `quotes` false the row simply ends at its first line terminator.
+    bool skip(parser::scope &sc, bool quotes = true) const
+    {
+        const dialect d = dialect_.get();
+        bool quoted = false;
+        bool field_start = true;
+        bool just_closed = false;
+        bool escaped = false;
+        std::optional<parser::position> first_line_end;
+        while (sc.has_next())
+        {
+            char c = sc.next_char();
+            if (c == '\n' && !first_line_end)
+                first_line_end = sc.pos;
+            if (quoted)
+            {
+                if (escaped)
+                {
+                    escaped = false;
+                } else if (c == d.quote)
+                {
+                    quoted = false;
+                    just_closed = true;
+                } else if (d.escape != '\0' && c == d.escape)
+                {
+                    escaped = true;
+                } else if (first_line_end &&
+                           sc.pos.get_abs_pos() - first_line_end->get_abs_pos() > max_quoted_lookahead)
+                {
+                    break;
+                }
+                continue;
+            }
+            if (c == '\n')
+                return true;
+            quoted = quotes && d.quote != '\0' && c == d.quote && (field_start || just_closed);
+            field_start = c == d.delimiter || (field_start && d.trim && is_blank(d, c));
+            just_closed = false;
+        }
+        if (quoted && first_line_end)
+        {
+            sc.pos = *first_line_end;
+            return false;
+        }
+        return !quoted;
+    }
+
+    [[nodiscard]] dialect get_dialect() const noexcept { return dialect_.get(); }
+
+  private:
+    static bool is_blank(const dialect &d, char c) noexcept
+    {
+        return (c == ' ' || c == '\t') && c != d.delimiter;
+    }
+
+    static bool is_special(const dialect &d, char c) noexcept
+    {
+        return c == d.delimiter || c == '\n' ||
+               (d.quote != '\0' && c == d.quote) ||
+               (c == '\r' && d.terminator != line_terminator::lf);
+    }
+
+    void skip_blanks(parser::scope &sc) const
+    {
+        const dialect d = dialect_.get();
+        while (sc.has_next() && is_blank(d, sc.peek_char()))
+            sc.next_char();
+    }
+
+    template<typename Sink>
+    std::optional<error> scan_cell(parser::scope &sc, Sink &sink) const
+    {
+        const dialect d = dialect_.get();
+        if (d.trim)
+            skip_blanks(sc);
+
+        if (d.quote != '\0' && sc.has_next() && sc.peek_char() == d.quote)
+        {
+            sc.next_char();
+            if (auto err = scan_quoted(sc, sink))
+                return err;
+            if (d.trim)
+                skip_blanks(sc);
+            return std::nullopt;
+        }
+
+        std::size_t trailing_blanks = 0;
+        while (sc.has_next())
+        {
+            char c = sc.peek_char();
+            if (is_special(d, c))
+                break;
+            sink.append(c);
+            trailing_blanks = d.trim && is_blank(d, c) ? trailing_blanks + 1 : 0;
+            sc.next_char();
+        }
+        if (trailing_blanks != 0)
+            sink.drop(trailing_blanks);
+        return std::nullopt;
+    }
+
+    template<typename Sink>
+    std::optional<error> scan_quoted(parser::scope &sc, Sink &sink) const
+    {
+        const dialect d = dialect_.get();
+        std::size_t until_discard = discard_interval;
+        while (true)
+        {
+            if constexpr (!detail::keeps_input<Sink>())
+            {
+                if (--until_discard == 0)
+                {
+                    sc.reader->discard_before(sc.pos);
+                    until_discard = discard_interval;
+                }
+            }
+            if (!sc.has_next())
+                return sc.raise_eof();
+            char c = sc.next_char();
+            if (c == d.quote)
+            {
+                if (d.escape != d.quote || !sc.has_next() || sc.peek_char() != d.quote)
+                    return std::nullopt;
+                sc.next_char();
+            } else if (d.escape != '\0' && c == d.escape)
+            {
+                if (!sc.has_next())
+                    return sc.raise_eof();
+                c = sc.next_char();
+            }
+            sink.append(c);
+        }
+    }
+
+    std::optional<error> scan_terminator(parser::scope &sc) const
+    {
+        const dialect d = dialect_.get();
+        char c = sc.peek_char();
+        if (c == '\n' && d.terminator != line_terminator::crlf)
+        {
+            sc.next_char();
+            return std::nullopt;
+        }
+        if (c == '\r' && d.terminator != line_terminator::lf)
+        {
+            sc.next_char();
+            if (sc.has_next() && sc.peek_char() == '\n')
+            {
+                sc.next_char();
+                return std::nullopt;
+            }
+        }
+        return sc.raise_expected("line terminator");
+    }
+
+    DialectT dialect_;
+};
+
+} // namespace csv
+
+#endif //CSV_ROW_SCANNER_HPP
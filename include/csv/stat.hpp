@@ -0,0 +1,256 @@
+#ifndef CSV_STAT_HPP
+#define CSV_STAT_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "csv/dialect.hpp"
+#include "parser/decompress.hpp"
+
+namespace csv {
+
+// Shape of a delimited file, either counted exactly or extrapolated from
+// evenly spaced samples of a large file.
+struct table_stat
+{
+    std::size_t bytes = 0;      // size of the decompressed input
+    std::size_t rows = 0;       // complete rows, header included
+    std::size_t columns = 0;    // cells in the first row
+    std::size_t cell_bytes = 0; // characters left after removing markup
+    bool sampled = false;
+};
+
+namespace detail {
+inline constexpr std::size_t stat_block_size = 1 << 20;
+inline constexpr std::size_t sampling_threshold = std::size_t{64} << 20;
+inline constexpr std::size_t sample_count = 32;
+inline constexpr std::size_t sample_size = 1 << 18;
+
+// Counts row terminators, delimiters and markup characters outside quoted
+// cells, passing over escaped characters inside them. Blocks without a quote character, which is the common case, are
+// handled by a branch-free loop the compiler vectorises.
+class stat_counter
+{
+  public:
+    explicit stat_counter(const dialect &d)
+            : d_(d) {}
+
+    void feed(const char *data, std::size_t size)
+    {
+        bytes_ += size;
+        while (columns_ == 0 && size != 0)
+        {
+            scan_char(*data++);
+            --size;
+        }
+        if (!quoted_ && (d_.quote == '\0' || std::memchr(data, d_.quote, size) == nullptr))
+        {
+            count_plain(data, size);
+            return;
+        }
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            scan_char(data[i]);
+        }
+    }
+
+    [[nodiscard]] std::size_t bytes() const noexcept { return bytes_; }
+
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+
+    [[nodiscard]] std::size_t columns() const noexcept { return columns_; }
+
+    [[nodiscard]] std::size_t markup() const noexcept { return markup_; }
+
+  private:
+    void scan_char(char c) noexcept
+    {
+        if (escaped_)
+        {
+            escaped_ = false;
+        } else if (d_.quote != '\0' && c == d_.quote)
+        {
+            quoted_ = !quoted_;
+            ++markup_;
+        } else if (quoted_)
+        {
+            if (d_.escape != '\0' && d_.escape != d_.quote && c == d_.escape)
+            {
+                escaped_ = true;
+                ++markup_;
+            }
+        } else if (c == d_.delimiter)
+        {
+            ++delimiters_;
+            ++markup_;
+        } else if (c == '\n')
+        {
+            end_row();
+            ++markup_;
+        } else if (c == '\r' && d_.terminator != line_terminator::lf)
+        {
+            ++markup_;
+        }
+    }
+
+    void count_plain(const char *data, std::size_t size) noexcept
+    {
+        const char delimiter = d_.delimiter;
+        std::size_t newlines = 0, delimiters = 0, returns = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            newlines += data[i] == '\n';
+            delimiters += data[i] == delimiter;
+            returns += data[i] == '\r';
+        }
+        if (d_.terminator == line_terminator::lf)
+            returns = 0;
+        rows_ += newlines;
+        markup_ += newlines + delimiters + returns;
+    }
+
+    void end_row() noexcept
+    {
+        if (columns_ == 0)
+            columns_ = delimiters_ + 1;
+        ++rows_;
+    }
+
+    const dialect d_;
+    std::size_t bytes_ = 0, rows_ = 0, columns_ = 0, delimiters_ = 0, markup_ = 0;
+    bool quoted_ = false;
+    bool escaped_ = false;
+};
+
+inline table_stat make_stat(const stat_counter &counter)
+{
+    table_stat result;
+    result.bytes = counter.bytes();
+    result.rows = counter.rows();
+    result.columns = counter.columns();
+    result.cell_bytes = counter.bytes() - counter.markup();
+    return result;
+}
+
+inline table_stat exact_stat(const std::string &path, const dialect &d)
+{
+    auto source = parser::open_source(path);
+    std::vector<char> buffer(stat_block_size);
+    stat_counter counter(d);
+    while (std::size_t got = source->read(buffer.data(), buffer.size()))
+    {
+        counter.feed(buffer.data(), got);
+    }
+    return make_stat(counter);
+}
+
+// Counts whole rows of the first block and of blocks spread evenly over the
+// file, each trimmed to its first and last newline, then scales the counts
+// to the file size. Samples are assumed to start outside quoted cells.
+inline table_stat sampled_stat(const std::string &path, const dialect &d, std::size_t file_size)
+{
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+    if (!file)
+    {
+        throw parser::input_reading_error(path);
+    }
+    std::vector<char> buffer(sample_size);
+    stat_counter head(d);
+    std::size_t got = std::fread(buffer.data(), 1, buffer.size(), file.get());
+    head.feed(buffer.data(), got);
+
+    std::size_t sampled_bytes = head.bytes(), rows = head.rows(), markup = head.markup();
+    for (std::size_t i = 1; i < sample_count; ++i)
+    {
+        std::size_t offset = file_size / sample_count * i;
+        if (std::fseek(file.get(), static_cast<long>(offset), SEEK_SET) != 0)
+            continue;
+        got = std::fread(buffer.data(), 1, buffer.size(), file.get());
+        const char *begin = static_cast<const char *>(std::memchr(buffer.data(), '\n', got));
+        const char *end = buffer.data() + got;
+        while (end != buffer.data() && end[-1] != '\n') --end;
+        if (begin == nullptr || begin + 1 >= end)
+            continue;
+        stat_counter sample(d);
+        sample.feed(begin + 1, end - begin - 1);
+        sampled_bytes += sample.bytes();
+        rows += sample.rows();
+        markup += sample.markup();
+    }
+
+    table_stat result;
+    double scale = static_cast<double>(file_size) / static_cast<double>(sampled_bytes);
+    result.bytes = file_size;
+    result.rows = static_cast<std::size_t>(static_cast<double>(rows) * scale);
+    result.columns = head.columns();
+    result.cell_bytes = file_size - static_cast<std::size_t>(static_cast<double>(markup) * scale);
+    result.sampled = true;
+    return result;
+}
+
+// What the first block of a file tells about the whole of it.
+struct head_stat
+{
+    parser::compression compression = parser::compression::none;
+    table_stat estimate{}; // only filled for uncompressed files
+};
+
+// Counts the first block of the file and scales the counts to the file size,
+// exact if the file fits in the block. Only that block is read, so a table
+// sized with it does not wait for the file to be read ahead of the parser.
+inline head_stat estimate_stat(const std::string &path, const dialect &d)
+{
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+    if (!file)
+    {
+        throw parser::input_reading_error(path);
+    }
+    std::vector<char> buffer(sample_size);
+    std::size_t got = std::fread(buffer.data(), 1, buffer.size(), file.get());
+
+    head_stat result;
+    result.compression = parser::detect_compression(reinterpret_cast<const unsigned char *>(buffer.data()), got);
+    if (result.compression != parser::compression::none)
+    {
+        return result;
+    }
+    stat_counter head(d);
+    head.feed(buffer.data(), got);
+    result.estimate = make_stat(head);
+    if (got < buffer.size())
+    {
+        return result;
+    }
+
+    std::size_t file_size = std::max<std::size_t>(std::filesystem::file_size(path), got);
+    double scale = static_cast<double>(file_size) / static_cast<double>(got);
+    result.estimate.bytes = file_size;
+    result.estimate.rows = static_cast<std::size_t>(static_cast<double>(head.rows()) * scale);
+    result.estimate.cell_bytes = file_size - static_cast<std::size_t>(static_cast<double>(head.markup()) * scale);
+    result.estimate.sampled = true;
+    return result;
+}
+} // namespace detail
+
+// Cheap pre-scan of a file: counts rows, columns and cell bytes without
+// parsing cells. Uncompressed files larger than 64 MiB are sampled.
+inline table_stat stat(const std::string &path, const dialect &d = dialects::standard)
+{
+    if (parser::detect_compression(path) == parser::compression::none)
+    {
+        std::size_t file_size = std::filesystem::file_size(path);
+        if (file_size > detail::sampling_threshold)
+        {
+            return detail::sampled_stat(path, d, file_size);
+        }
+    }
+    return detail::exact_stat(path, d);
+}
+
+} // namespace csv
+
+#endif //CSV_STAT_HPP
@@ -0,0 +1,130 @@
+#ifndef CSV_STREAM_HPP
+#define CSV_STREAM_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "csv/csv_parser.hpp"
+
+namespace csv {
+
+namespace detail {
+// Scanner sink keeping the cells of the current row in one buffer that is
+// reused for every row, so streaming allocates nothing once it is warm.
+class row_buffer
+{
+  public:
+    void clear()
+    {
+        cells_.clear();
+        offsets_.assign(1, 0);
+        open_ = false;
+    }
+
+    void begin_cell()
+    {
+        if (open_)
+        {
+            offsets_.push_back(cells_.size());
+        }
+        open_ = true;
+    }
+
+    void append(char c) { cells_.push_back(c); }
+
+    void drop(std::size_t count) { cells_.resize(cells_.size() - count); }
+
+    row_view finish()
+    {
+        if (open_)
+        {
+            offsets_.push_back(cells_.size());
+            open_ = false;
+        }
+        return {cells_.data(), offsets_.data(), offsets_.size() - 1};
+    }
+
+  private:
+    std::string cells_{};
+    std::vector<std::size_t> offsets_{0};
+    bool open_ = false;
+};
+
+// Passes every row to the handler as soon as it is scanned. Errors are
+// handled like in import_rows(), except that a width mismatch is reported
+// at once since the preceding rows have already been consumed.
+template<typename DialectT, typename Handler>
+void stream_rows(parser::scope &sc, const row_scanner<DialectT> &scanner,
+                 bool header, error_log *errors, Handler &handler)
+{
+    row_buffer buffer;
+    std::size_t width = 0;
+    bool header_pending = header;
+    bool quotes = true;
+    while (sc.has_next())
+    {
+        parser::position start = sc.pos;
+        sc.reader->discard_before(start);
+        buffer.clear();
+        if (auto error = scanner.scan(sc, buffer))
+        {
+            if (!errors)
+            {
+                throw parser::exception::positional_error(start, "'EOF' is expected here");
+            }
+            skip_malformed(sc, scanner, start, *error, *errors, quotes);
+            continue;
+        }
+        row_view row = buffer.finish();
+        if (width != 0 && row.size() != width)
+        {
+            if (!errors)
+            {
+                throw std::logic_error(width_mismatch);
+            }
+            errors->record(start, width_mismatch);
+            continue;
+        }
+        width = row.size();
+        if (header_pending)
+        {
+            header_pending = false;
+            handler.header(row);
+        } else
+        {
+            handler.row(row);
+        }
+    }
+}
+
+template<typename Handler>
+void stream(const std::string &filename, const dialect &d, Handler &handler, error_log *errors)
+{
+    parser::scope s(open_input(filename), parser::position());
+    visit_dialect(d, [&](auto fixed) {
+        stream_rows(s, row_scanner(fixed), d.header, errors, handler);
+    });
+}
+} // namespace detail
+
+// Parses a file without building a table: the handler's header(row_view)
+// is called for the header row of a dialect with a header, row(row_view)
+// for every other row. The views are only valid during the call.
+template<typename Handler>
+void stream_csv(const std::string &filename, const dialect &d, Handler &handler)
+{
+    detail::stream(filename, d, handler, nullptr);
+}
+
+// Lenient streaming: malformed rows and rows of a wrong width are recorded
+// in `errors` and skipped.
+template<typename Handler>
+void stream_csv(const std::string &filename, const dialect &d, Handler &handler, error_log &errors)
+{
+    detail::stream(filename, d, handler, &errors);
+}
+
+} // namespace csv
+
+#endif //CSV_STREAM_HPP
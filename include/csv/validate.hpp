@@ -0,0 +1,83 @@
+#ifndef CSV_VALIDATE_HPP
+#define CSV_VALIDATE_HPP
+
+#include <optional>
+#include <string>
+
+#include "csv/csv_parser.hpp"
+
+namespace csv {
+
+struct validation_result
+{
+    // Rows before the first error, not counting the header.
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+    std::optional<row_error> error{};
+
+    [[nodiscard]] bool ok() const noexcept { return !error; }
+};
+
+namespace detail {
+// Scanner sink that only counts the cells of a row.
+struct cell_counter
+{
+    static constexpr bool keeps_input = false;
+
+    std::size_t cells = 0;
+
+    void begin_cell() { ++cells; }
+
+    void append(char) {}
+
+    void drop(std::size_t) {}
+};
+
+// Runs the scanner over the input keeping no cells, only their number to
+// check the width. Only the current row of the input is kept, and not even
+// all of it when a quoted cell runs over many blocks.
+template<typename DialectT>
+validation_result validate_rows(parser::scope &sc, const row_scanner<DialectT> &scanner, bool header)
+{
+    validation_result result;
+    bool header_pending = header;
+    while (sc.has_next())
+    {
+        parser::position start = sc.pos;
+        sc.reader->discard_before(start);
+        cell_counter counter;
+        if (auto error = scanner.scan(sc, counter))
+        {
+            result.error = row_error{start, error->get_reason(), error->get_position()};
+            break;
+        }
+        if (result.columns != 0 && counter.cells != result.columns)
+        {
+            result.error = row_error{start, width_mismatch};
+            break;
+        }
+        result.columns = counter.cells;
+        if (header_pending)
+            header_pending = false;
+        else
+            ++result.rows;
+    }
+    return result;
+}
+} // namespace detail
+
+// Checks that a file is well-formed with rows of equal width, without
+// building a table. Stops at the first malformed row or width mismatch,
+// whichever comes first, and reports the position where that row starts
+// with the same reason a lenient import records.
+inline validation_result validate(const std::string &filename, const dialect &d = dialects::standard)
+{
+    parser::scope s(detail::open_input(filename), parser::position());
+    return visit_dialect(d, [&](auto fixed) {
+        return detail::validate_rows(s, row_scanner(fixed), d.header);
+    });
+}
+
+} // namespace csv
+
+#endif //CSV_VALIDATE_HPP
@@ -38,7 +38,7 @@ class parser_error : public std::exception {
 class positional_error : public parser_error {
   public:
     explicit positional_error(const position &pos, const std::string &message)
-        : parser_error("at " + pos.format() + ": " + message), position_(pos)
+        : parser_error("at " + pos.format() + ": " + message), position_(pos), reason_(message)
     {
     }
 
@@ -47,8 +47,15 @@ class positional_error : public parser_error {
         return position_;
     }
 
+    // The message without the prefix and the position.
+    [[nodiscard]] const std::string &get_reason() const noexcept
+    {
+        return reason_;
+    }
+
   protected:
     const position position_;
+    const std::string reason_;
 };
 
 } // namespace parser::exception
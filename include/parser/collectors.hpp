@@ -1,5 +1,25 @@
 #ifndef PARSER_COLLECTOR_HPP
 #define PARSER_COLLECTOR_HPP
 
+#include <cstddef>
+
+namespace parser {
+
+// Counts the matches of a parser wrapped with m_count(), so that the shape
+// of the input can be checked while no tree is built.
+class counter
+{
+  public:
+    void add() noexcept { ++count_; }
+
+    void reset() noexcept { count_ = 0; }
+
+    [[nodiscard]] std::size_t count() const noexcept { return count_; }
+
+  private:
+    std::size_t count_ = 0;
+};
+
+} // namespace parser
 
 #endif //PARSER_COLLECTOR_HPP
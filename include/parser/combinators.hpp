@@ -9,7 +9,7 @@
 
 namespace parser {
 namespace detail {
-std::string concat_charset(const std::unordered_set<char> &charset)
+inline std::string concat_charset(const std::unordered_set<char> &charset)
 {
     std::stringstream chars;
     for (char c : charset) chars.put(c);
@@ -51,6 +51,8 @@ class predicate_parser : public parser
         if (!predicate_(c))
             return sc.raise_expected(name_);
 
+        if (!sc.build_ast)
+            return nullptr;
         return ast::make_node(std::string{c});
     }
 
@@ -67,6 +69,8 @@ class eof_parser : public parser
         if (sc.has_next())
             return sc.raise_expected("EOF");
 
+        if (!sc.build_ast)
+            return nullptr;
         return ast::make_node("EOF");
     }
 };
@@ -106,6 +110,13 @@ class not_charset_parser : public predicate_parser<std::function<bool(char)>>
     }, "not any char from " + detail::concat_charset(charset)) {}
 };
 
+class any_char_parser : public predicate_parser<std::function<bool(char)>>
+{
+  public:
+    explicit any_char_parser()
+            : predicate_parser([](char) { return true; }, "any char") {}
+};
+
 class at_least_parser : public inner_parser_container_
 {
   public:
@@ -118,14 +129,15 @@ class at_least_parser : public inner_parser_container_
 
     maybe_error parse(scope &sc) override
     {
-        ast::node_ptr node = ast::make_node("At least " + std::to_string(at_least_));
+        ast::node_ptr node = sc.build_ast ? ast::make_node("At least " + std::to_string(at_least_)) : nullptr;
         for (std::size_t i = 0; i < at_least_; ++i)
         {
             auto result = inner_->parse(sc);
             if (!no_error(result))
                 return get_error(result);
 
-            node->append_child(get_ast(result));
+            if (node)
+                node->append_child(get_ast(result));
         }
         bool success = true;
         while (success)
@@ -133,7 +145,7 @@ class at_least_parser : public inner_parser_container_
             auto result = try_inner_->parse(sc);
             if (!no_error(result))
                 success = false;
-            else
+            else if (node)
                 node->append_child(get_ast(result));
         }
         return node;
@@ -161,7 +173,7 @@ class seq_parser : public parser
 
     maybe_error parse(scope &sc) override
     {
-        ast::node_ptr node = ast::make_node("Sequence");
+        ast::node_ptr node = sc.build_ast ? ast::make_node("Sequence") : nullptr;
         for (auto &&item : sequence_)
         {
             auto result = item->parse(sc);
@@ -169,7 +181,8 @@ class seq_parser : public parser
             {
                 return get_error(result);
             }
-            node->append_child(get_ast(result));
+            if (node)
+                node->append_child(get_ast(result));
         }
         return node;
     }
@@ -188,11 +201,12 @@ class separator_parser : public parser
 
     maybe_error parse(scope &sc) override
     {
-        ast::node_ptr node = ast::make_node("Separator");
+        ast::node_ptr node = sc.build_ast ? ast::make_node("Separator") : nullptr;
         auto result = value_->parse(sc);
         if (!no_error(result))
             return get_error(result);
-        node->append_child(get_ast(result));
+        if (node)
+            node->append_child(get_ast(result));
         while (true)
         {
             position_rollback rollback(sc);
@@ -202,7 +216,8 @@ class separator_parser : public parser
             auto value_result = value_->parse(sc);
             if (!no_error(value_result))
                 return node;
-            node->append_child(get_ast(value_result));
+            if (node)
+                node->append_child(get_ast(value_result));
             rollback.cancel();
         }
     }
@@ -262,6 +277,8 @@ class concat_parser : public inner_parser_container_
         auto result = inner_->parse(sc);
         if (!no_error(result))
             return get_error(result);
+        if (!sc.build_ast)
+            return nullptr;
         std::stringstream ss;
         for (auto &&sn : ast::nodes(get_ast(result)))
         {
@@ -283,11 +300,57 @@ class erase_parser : public inner_parser_container_
         if (!no_error(result))
             return get_error(result);
         auto node = get_ast(result);
-        node->disable();
+        if (node)
+            node->disable();
         return node;
     }
 };
 
+class trim_parser : public inner_parser_container_
+{
+  public:
+    explicit trim_parser(const parser_ptr &inner, std::unordered_set<char> blanks)
+            : inner_parser_container_(inner), blanks_(std::move(blanks))
+    {
+    }
+
+    maybe_error parse(scope &sc) override
+    {
+        auto result = inner_->parse(sc);
+        if (!no_error(result) || !sc.build_ast)
+            return result;
+        const std::string &name = get_ast(result)->get_name();
+        std::size_t begin = 0, end = name.size();
+        while (begin < end && blanks_.count(name[begin])) ++begin;
+        while (end > begin && blanks_.count(name[end - 1])) --end;
+        return ast::make_node(name.substr(begin, end - begin));
+    }
+
+  private:
+    std::unordered_set<char> blanks_;
+};
+
+// Adds every successful match of the inner parser to a counter.
+class count_parser : public inner_parser_container_
+{
+  public:
+    explicit count_parser(const parser_ptr &inner, std::shared_ptr<counter> matches)
+            : inner_parser_container_(inner), matches_(std::move(matches))
+    {
+    }
+
+    maybe_error parse(scope &sc) override
+    {
+        auto result = inner_->parse(sc);
+        if (no_error(result))
+            matches_->add();
+        return result;
+    }
+
+  private:
+    std::shared_ptr<counter> matches_;
+};
+
 namespace aliases {
 
 inline parser_ptr m_concat(const parser_ptr &p) { return make_parser<concat_parser>(p); }
@@ -302,6 +365,18 @@ inline parser_ptr m_char(char c) { return make_parser<char_parser>(c); }
 
 inline parser_ptr m_not_char(char c) { return make_parser<not_char_parser>(c); }
 
+inline parser_ptr m_any_char() { return make_parser<any_char_parser>(); }
+
+inline parser_ptr m_trim(const parser_ptr &p, std::unordered_set<char> blanks)
+{
+    return make_parser<trim_parser>(p, std::move(blanks));
+}
+
+inline parser_ptr m_count(const parser_ptr &p, std::shared_ptr<counter> matches)
+{
+    return make_parser<count_parser>(p, std::move(matches));
+}
+
 inline parser_ptr m_charset(std::unordered_set<char> s) { return make_parser<charset_parser>(std::move(s)); }
 
 inline parser_ptr m_not_charset(std::unordered_set<char> s) { return make_parser<not_charset_parser>(std::move(s)); }
@@ -346,6 +421,8 @@ inline parser_ptr m_eof(const parser_ptr &p) { return m_seq(p, make_parser<eof_p
 
 inline parser_ptr m_line(const parser_ptr &p) { return m_seq(p, m_ignore(m_char('\n'))); }
 
+inline parser_ptr m_line(const parser_ptr &p, const parser_ptr &terminator) { return m_seq(p, m_ignore(terminator)); }
+
 
 } // namespace aliases
 } // namespace parser
@@ -0,0 +1,215 @@
+#ifndef PARSER_DECOMPRESS_HPP
+#define PARSER_DECOMPRESS_HPP
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "parser/pipelined_reader.hpp"
+
+#ifdef PARSE_CSV_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef PARSE_CSV_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace parser {
+
+namespace detail {
+inline constexpr std::size_t compressed_buffer_size = 1 << 18;
+} // namespace detail
+
+#ifdef PARSE_CSV_WITH_ZLIB
+// Inflates a gzip (or zlib) stream, including concatenated gzip members.
+class gzip_source : public block_source
+{
+  public:
+    explicit gzip_source(std::unique_ptr<block_source> compressed, std::string info)
+            : compressed_(std::move(compressed)),
+              info_(std::move(info)),
+              buffer_(detail::compressed_buffer_size)
+    {
+        if (inflateInit2(&stream_, 15 + 32) != Z_OK)
+        {
+            throw input_reading_error(info_, "can not initialise zlib");
+        }
+    }
+
+    gzip_source(const gzip_source &) = delete;
+
+    gzip_source &operator=(const gzip_source &) = delete;
+
+    ~gzip_source() override { inflateEnd(&stream_); }
+
+    std::size_t read(char *dst, std::size_t size) override
+    {
+        stream_.next_out = reinterpret_cast<Bytef *>(dst);
+        stream_.avail_out = static_cast<uInt>(size);
+        while (stream_.avail_out == size)
+        {
+            if (stream_.avail_in == 0 && !input_done_)
+            {
+                std::size_t got = compressed_->read(buffer_.data(), buffer_.size());
+                input_done_ = got == 0;
+                stream_.next_in = reinterpret_cast<Bytef *>(buffer_.data());
+                stream_.avail_in = static_cast<uInt>(got);
+            }
+            if (member_done_)
+            {
+                if (stream_.avail_in == 0)
+                    break;
+                inflateReset(&stream_);
+                member_done_ = false;
+            }
+            int rc = inflate(&stream_, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END)
+                member_done_ = true;
+            else if (rc == Z_BUF_ERROR && input_done_)
+                throw input_reading_error(info_, "truncated gzip stream");
+            else if (rc != Z_OK && rc != Z_BUF_ERROR)
+                throw input_reading_error(info_, stream_.msg ? stream_.msg : "corrupt gzip stream");
+        }
+        return size - stream_.avail_out;
+    }
+
+  private:
+    std::unique_ptr<block_source> compressed_;
+    const std::string info_;
+    std::vector<char> buffer_;
+    z_stream stream_{};
+    bool input_done_ = false;
+    bool member_done_ = false;
+};
+#endif
+
+#ifdef PARSE_CSV_WITH_ZSTD
+class zstd_source : public block_source
+{
+  public:
+    explicit zstd_source(std::unique_ptr<block_source> compressed, std::string info)
+            : compressed_(std::move(compressed)),
+              info_(std::move(info)),
+              buffer_(detail::compressed_buffer_size),
+              stream_(ZSTD_createDStream())
+    {
+        if (stream_ == nullptr || ZSTD_isError(ZSTD_initDStream(stream_)))
+        {
+            ZSTD_freeDStream(stream_);
+            throw input_reading_error(info_, "can not initialise zstd");
+        }
+    }
+
+    zstd_source(const zstd_source &) = delete;
+
+    zstd_source &operator=(const zstd_source &) = delete;
+
+    ~zstd_source() override { ZSTD_freeDStream(stream_); }
+
+    std::size_t read(char *dst, std::size_t size) override
+    {
+        ZSTD_outBuffer out{dst, size, 0};
+        while (out.pos == 0)
+        {
+            if (input_.pos == input_.size && !input_done_)
+            {
+                std::size_t got = compressed_->read(buffer_.data(), buffer_.size());
+                input_done_ = got == 0;
+                input_ = ZSTD_inBuffer{buffer_.data(), got, 0};
+            }
+            std::size_t consumed = input_.pos;
+            std::size_t rc = ZSTD_decompressStream(stream_, &out, &input_);
+            if (ZSTD_isError(rc))
+                throw input_reading_error(info_, ZSTD_getErrorName(rc));
+            // Past the end of a frame a call without input asks for the
+            // header of the next one, so only a call that made progress
+            // tells whether the frame is complete.
+            if (input_.pos != consumed || out.pos != 0)
+                frame_pending_ = rc != 0;
+            if (input_done_ && out.pos == 0)
+            {
+                if (frame_pending_)
+                    throw input_reading_error(info_, "truncated zstd stream");
+                break;
+            }
+        }
+        return out.pos;
+    }
+
+  private:
+    std::unique_ptr<block_source> compressed_;
+    const std::string info_;
+    std::vector<char> buffer_;
+    ZSTD_DStream *stream_;
+    ZSTD_inBuffer input_{nullptr, 0, 0};
+    bool input_done_ = false;
+    bool frame_pending_ = false;
+};
+#endif
+
+enum class compression
+{
+    none,
+    gzip,
+    zstd
+};
+
+// Recognises a compressed stream by the magic bytes at its start.
+inline compression detect_compression(const unsigned char *magic, std::size_t size)
+{
+    if (size >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+        return compression::gzip;
+    if (size >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+        return compression::zstd;
+    return compression::none;
+}
+
+inline compression detect_compression(const std::string &file_path)
+{
+    std::array<unsigned char, 4> magic{};
+    std::ifstream input(file_path, std::ios::binary);
+    if (!input.is_open())
+    {
+        throw input_reading_error(file_path);
+    }
+    input.read(reinterpret_cast<char *>(magic.data()), magic.size());
+    return detect_compression(magic.data(), static_cast<std::size_t>(input.gcount()));
+}
+
+// Opens the file as a stream of plain bytes, decompressing it as `kind`.
+inline std::unique_ptr<block_source> open_source(const std::string &file_path, compression kind)
+{
+    auto file = std::make_unique<file_source>(file_path);
+    switch (kind)
+    {
+        case compression::none:
+            return file;
+        case compression::gzip:
+#ifdef PARSE_CSV_WITH_ZLIB
+            return std::make_unique<gzip_source>(std::move(file), file_path);
+#else
+            throw input_reading_error(file_path, "gzip support is not compiled in");
+#endif
+        case compression::zstd:
+#ifdef PARSE_CSV_WITH_ZSTD
+            return std::make_unique<zstd_source>(std::move(file), file_path);
+#else
+            throw input_reading_error(file_path, "zstd support is not compiled in");
+#endif
+    }
+    return file;
+}
+
+// Opens the file as a stream of plain bytes, decompressing gzip and zstd
+// files recognised by their magic bytes.
+inline std::unique_ptr<block_source> open_source(const std::string &file_path)
+{
+    return open_source(file_path, detect_compression(file_path));
+}
+
+} // namespace parser
+
+#endif // PARSER_DECOMPRESS_HPP
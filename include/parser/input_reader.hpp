@@ -21,7 +21,7 @@ class input_reading_error : public exception::parser_error
 
     explicit input_reading_error(const std::string &input_info,
                                  const std::string &message)
-            : parser_error("Can not read from " + input_info + ": ")
+            : parser_error("Can not read from " + input_info + ": " + message)
     {
     }
 };
@@ -39,6 +39,8 @@ class input_out_of_range_error : public input_reading_error
 class input_reader
 {
   public:
+    virtual ~input_reader() = default;
+
     int read_at(const position &pos)
     {
         if (!can_read(pos))
@@ -61,6 +63,10 @@ class input_reader
 
     virtual bool can_read(const position &) = 0;
 
+    // Promise that nothing before the position will be read again, so a
+    // streaming reader may drop that part of the input.
+    virtual void discard_before(const position &) {}
+
     [[nodiscard]] const std::string &get_info() const noexcept
     {
         return input_info_;
@@ -99,6 +105,68 @@ class full_file_reader : public input_reader
     std::string content_;
 };
 
+class string_reader : public input_reader
+{
+  public:
+    explicit string_reader(std::string content)
+            : content_(std::move(content))
+    {
+    }
+
+    bool can_read(const position &pos) override
+    {
+        return pos.get_abs_pos() < content_.length();
+    }
+
+  private:
+    char read_char_if_can(const position &pos) override
+    {
+        return content_[pos.get_abs_pos()];
+    }
+
+    std::string content_;
+};
+
+// Reads a file lazily, chunk by chunk, starting from a byte offset.
+// Positions are relative to that offset.
+class offset_file_reader : public input_reader
+{
+  public:
+    explicit offset_file_reader(const std::string &file_path, std::size_t offset,
+                                std::size_t chunk_size = 1 << 16)
+            : input_(file_path, std::ios::binary), chunk_size_(chunk_size)
+    {
+        if (!input_.is_open() || !input_.seekg(static_cast<std::streamoff>(offset)))
+        {
+            throw input_reading_error(file_path);
+        }
+    }
+
+    bool can_read(const position &pos) override
+    {
+        while (pos.get_abs_pos() >= content_.length() && !exhausted_)
+        {
+            std::size_t size = content_.length();
+            content_.resize(size + chunk_size_);
+            input_.read(content_.data() + size, static_cast<std::streamsize>(chunk_size_));
+            content_.resize(size + static_cast<std::size_t>(input_.gcount()));
+            exhausted_ = input_.gcount() == 0;
+        }
+        return pos.get_abs_pos() < content_.length();
+    }
+
+  private:
+    char read_char_if_can(const position &pos) override
+    {
+        return content_[pos.get_abs_pos()];
+    }
+
+    std::ifstream input_;
+    const std::size_t chunk_size_;
+    std::string content_{};
+    bool exhausted_ = false;
+};
+
 } // namespace parser
 
 #endif // PARSER_INPUT_READER
@@ -0,0 +1,204 @@
+#ifndef PARSER_PIPELINED_READER_HPP
+#define PARSER_PIPELINED_READER_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "parser/input_reader.hpp"
+#include "parser/spsc_queue.hpp"
+
+namespace parser {
+
+// Sequential producer of raw input bytes for the pipelined reader.
+class block_source
+{
+  public:
+    virtual ~block_source() = default;
+
+    // Reads up to `size` bytes into `dst`, returns 0 only at the end of input.
+    virtual std::size_t read(char *dst, std::size_t size) = 0;
+};
+
+class file_source : public block_source
+{
+  public:
+    explicit file_source(const std::string &file_path)
+            : file_(std::fopen(file_path.c_str(), "rb")), file_path_(file_path)
+    {
+        if (!file_)
+        {
+            throw input_reading_error(file_path);
+        }
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    }
+
+    file_source(const file_source &) = delete;
+
+    file_source &operator=(const file_source &) = delete;
+
+    ~file_source() override { std::fclose(file_); }
+
+    std::size_t read(char *dst, std::size_t size) override
+    {
+        std::size_t got = std::fread(dst, 1, size, file_);
+        if (got == 0 && std::ferror(file_))
+        {
+            throw input_reading_error(file_path_);
+        }
+        return got;
+    }
+
+  private:
+    std::FILE *file_;
+    const std::string file_path_;
+};
+
+// Reads the source on a background thread in fixed-size blocks, so that
+// the parser works on earlier blocks while later ones are being read.
+// Blocks are kept until discard_before() moves past them and are then
+// handed back to the reader thread for reuse.
+class pipelined_reader : public input_reader
+{
+  public:
+    static constexpr std::size_t default_block_size = 1 << 20;
+    static constexpr std::size_t default_depth = 4;
+
+    explicit pipelined_reader(std::unique_ptr<block_source> source,
+                              std::size_t block_size = default_block_size,
+                              std::size_t depth = default_depth)
+            : source_(std::move(source)),
+              block_size_(block_size),
+              filled_(depth),
+              recycled_(depth),
+              producer_([this] { produce(); })
+    {
+    }
+
+    pipelined_reader(const pipelined_reader &) = delete;
+
+    pipelined_reader &operator=(const pipelined_reader &) = delete;
+
+    ~pipelined_reader() override
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        std::string block;
+        while (!finished_.load(std::memory_order_acquire))
+        {
+            while (filled_.try_pop(block)) {}
+            std::this_thread::yield();
+        }
+        producer_.join();
+    }
+
+    bool can_read(const position &pos) override
+    {
+        std::size_t at = pos.get_abs_pos();
+        while (at >= end_ && !exhausted_)
+        {
+            fetch();
+        }
+        if (at < begin_)
+        {
+            throw input_out_of_range_error(get_info(), pos);
+        }
+        return at < end_;
+    }
+
+    void discard_before(const position &pos) override
+    {
+        while (!window_.empty() && begin_ + window_.front().size() <= pos.get_abs_pos())
+        {
+            begin_ += window_.front().size();
+            recycled_.try_push(window_.front());
+            window_.pop_front();
+            cached_size_ = 0;
+        }
+    }
+
+  private:
+    char read_char_if_can(const position &pos) override
+    {
+        std::size_t at = pos.get_abs_pos();
+        if (at - cached_begin_ >= cached_size_)
+        {
+            const std::string &block = window_[(at - begin_) / block_size_];
+            cached_begin_ = at - (at - begin_) % block_size_;
+            cached_data_ = block.data();
+            cached_size_ = block.size();
+        }
+        return cached_data_[at - cached_begin_];
+    }
+
+    void fetch()
+    {
+        std::string block = filled_.pop();
+        if (block.empty())
+        {
+            exhausted_ = true;
+            if (error_)
+            {
+                std::rethrow_exception(error_);
+            }
+            return;
+        }
+        end_ += block.size();
+        window_.push_back(std::move(block));
+    }
+
+    void produce()
+    {
+        try
+        {
+            bool last = false;
+            while (!last && !stop_.load(std::memory_order_relaxed))
+            {
+                std::string block;
+                recycled_.try_pop(block);
+                block.resize(block_size_);
+                std::size_t size = 0;
+                while (size < block_size_)
+                {
+                    std::size_t got = source_->read(block.data() + size, block_size_ - size);
+                    if (got == 0)
+                        break;
+                    size += got;
+                }
+                block.resize(size);
+                last = size < block_size_;
+                if (size != 0)
+                    filled_.push(std::move(block));
+            }
+        } catch (...)
+        {
+            error_ = std::current_exception();
+        }
+        filled_.push(std::string());
+        finished_.store(true, std::memory_order_release);
+    }
+
+    std::unique_ptr<block_source> source_;
+    const std::size_t block_size_;
+
+    // Consumer side: blocks covering [begin_, end_) of the input.
+    std::deque<std::string> window_{};
+    std::size_t begin_ = 0, end_ = 0;
+    bool exhausted_ = false;
+    const char *cached_data_ = nullptr;
+    std::size_t cached_begin_ = 0, cached_size_ = 0;
+
+    spsc_queue<std::string> filled_;
+    spsc_queue<std::string> recycled_;
+    std::exception_ptr error_{};
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> finished_{false};
+    std::thread producer_;
+};
+
+} // namespace parser
+
+#endif // PARSER_PIPELINED_READER_HPP
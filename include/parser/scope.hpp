@@ -13,6 +13,8 @@ struct scope
 {
     std::shared_ptr<input_reader> reader;
     position pos;
+    // When false the parsers only check the input and return no nodes.
+    bool build_ast = true;
 
     scope(std::shared_ptr<input_reader> reader, position pos)
             : reader(std::move(reader)), pos(pos)
@@ -45,6 +47,8 @@ struct scope
 
     char next_char() { return reader->read_and_move(pos); }
 
+    char peek_char() { return static_cast<char>(reader->read_at(pos)); }
+
     bool has_next() { return reader->can_read(pos); }
 };
 
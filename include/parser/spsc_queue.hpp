@@ -0,0 +1,84 @@
+#ifndef PARSER_SPSC_QUEUE_HPP
+#define PARSER_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace parser {
+
+// Bounded lock-free queue for exactly one producer and one consumer thread.
+// The blocking operations sleep on the opposite index with atomic wait, so
+// an idle side does not spin.
+template<typename T>
+class spsc_queue
+{
+  public:
+    explicit spsc_queue(std::size_t capacity)
+            : slots_(capacity + 1) {}
+
+    spsc_queue(const spsc_queue &) = delete;
+
+    spsc_queue &operator=(const spsc_queue &) = delete;
+
+    bool try_push(T &value)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t next = advance(tail);
+        if (next == head_.load(std::memory_order_acquire))
+            return false;
+        slots_[tail] = std::move(value);
+        tail_.store(next, std::memory_order_release);
+        tail_.notify_one();
+        return true;
+    }
+
+    bool try_pop(T &value)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        value = std::move(slots_[head]);
+        head_.store(advance(head), std::memory_order_release);
+        head_.notify_one();
+        return true;
+    }
+
+    void push(T value)
+    {
+        while (!try_push(value))
+        {
+            std::size_t head = head_.load(std::memory_order_acquire);
+            if (advance(tail_.load(std::memory_order_relaxed)) == head)
+                head_.wait(head, std::memory_order_acquire);
+        }
+    }
+
+    T pop()
+    {
+        T value;
+        while (!try_pop(value))
+        {
+            std::size_t tail = tail_.load(std::memory_order_acquire);
+            if (head_.load(std::memory_order_relaxed) == tail)
+                tail_.wait(tail, std::memory_order_acquire);
+        }
+        return value;
+    }
+
+  private:
+    [[nodiscard]] std::size_t advance(std::size_t index) const noexcept
+    {
+        return index + 1 == slots_.size() ? 0 : index + 1;
+    }
+
+    std::vector<T> slots_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+} // namespace parser
+
+#endif // PARSER_SPSC_QUEUE_HPP
@@ -1,22 +1,168 @@
+#include <charconv>
 #include <iostream>
+#include <optional>
+#include <string>
 
 #include "csv/csv_parser.hpp"
+#include "csv/export.hpp"
+#include "csv/validate.hpp"
+
+namespace {
+
+void print_usage()
+{
+    std::cerr << "Usage: parse-csv [options] <path>\n"
+                 "  --lenient[=N]      skip malformed rows, aborting after more than N of them\n"
+                 "  --dialect=NAME     standard, rfc4180, semicolon or tsv\n"
+                 "  --header           treat the first row as a header\n"
+                 "  --trim             strip blanks around cells\n"
+                 "  --to=FORMAT        convert to jsonl or columnar instead of printing\n"
+                 "  --check            only validate the file\n";
+}
+
+std::optional<std::size_t> parse_count(const std::string &text)
+{
+    std::size_t count = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), count);
+    if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+    return count;
+}
+
+} // namespace
 
 int main(int argc, const char **argv)
 {
-    if (argc < 2)
+    std::optional<csv::error_log> errors;
+    csv::dialect dialect = csv::dialects::standard;
+    std::string format = "table";
+    bool check = false;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--lenient")
+        {
+            errors.emplace();
+        } else if (arg.rfind("--lenient=", 0) == 0)
+        {
+            std::string budget = arg.substr(std::string("--lenient=").size());
+            std::optional<std::size_t> count = parse_count(budget);
+            if (!count)
+            {
+                std::cerr << "Invalid error budget '" << budget << "': expected a non-negative number" << std::endl;
+                print_usage();
+                return 1;
+            }
+            errors.emplace(*count);
+        } else if (arg.rfind("--dialect=", 0) == 0)
+        {
+            bool header = dialect.header, trim = dialect.trim;
+            try
+            {
+                dialect = csv::dialect_by_name(arg.substr(std::string("--dialect=").size()));
+            } catch (const std::invalid_argument &e)
+            {
+                std::cerr << e.what() << std::endl;
+                print_usage();
+                return 1;
+            }
+            dialect.header = header;
+            dialect.trim = trim;
+        } else if (arg == "--header")
+        {
+            dialect.header = true;
+        } else if (arg == "--trim")
+        {
+            dialect.trim = true;
+        } else if (arg == "--check")
+        {
+            check = true;
+        } else if (arg.rfind("--to=", 0) == 0)
+        {
+            format = arg.substr(std::string("--to=").size());
+        } else
+        {
+            path = argv[i];
+        }
+    }
+    if (check && (errors || format != "table"))
+    {
+        std::cerr << "--check can not be combined with --lenient or --to" << std::endl;
+        print_usage();
+        return 1;
+    }
+    if (path == nullptr)
     {
         std::cout << "Specify path to csv file as first argument" << std::endl;
         return 0;
     }
+    // Skipped rows are reported even if the import is aborted afterwards,
+    // since they tell where the input is broken.
+    auto print_skipped = [&] {
+        if (!errors)
+        {
+            return;
+        }
+        for (const auto &e : errors->errors())
+        {
+            std::cerr << "Skipped row at " << e.pos.format() << ": " << e.reason;
+            if (e.at)
+            {
+                std::cerr << " (at " << e.at->format() << ")";
+            }
+            std::cerr << std::endl;
+        }
+    };
     try
     {
-        std::cout << csv::import_csv(argv[1]) << std::endl;
+        if (check)
+        {
+            csv::validation_result result = csv::validate(path, dialect);
+            if (!result.ok())
+            {
+                std::cout << "Invalid row at " << result.error->pos.format() << " after " << result.rows
+                          << " rows: " << result.error->reason;
+                if (result.error->at)
+                {
+                    std::cout << " (at " << result.error->at->format() << ")";
+                }
+                std::cout << std::endl;
+                return 1;
+            }
+            std::cout << "Valid: " << result.rows << " rows, " << result.columns << " columns" << std::endl;
+        } else if (format == "jsonl")
+        {
+            csv::jsonl_writer writer(std::cout);
+            errors ? csv::stream_csv(path, dialect, writer, *errors) : csv::stream_csv(path, dialect, writer);
+            writer.finish();
+        } else if (format == "columnar")
+        {
+            csv::columnar_writer writer(std::cout);
+            errors ? csv::stream_csv(path, dialect, writer, *errors) : csv::stream_csv(path, dialect, writer);
+            writer.finish();
+        } else if (format != "table")
+        {
+            std::cerr << "Unknown output format '" << format << "'" << std::endl;
+            return 1;
+        } else if (errors)
+        {
+            std::cout << csv::import_csv(path, dialect, *errors) << std::endl;
+        } else
+        {
+            std::cout << csv::import_csv(path, dialect) << std::endl;
+        }
+        print_skipped();
     } catch (const std::exception &e)
     {
+        print_skipped();
         std::cerr << e.what() << std::endl;
+        return 1;
     } catch (...)
     {
         std::cerr << "Unknown error occurred" << std::endl;
+        return 1;
     }
 }